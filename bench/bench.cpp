@@ -0,0 +1,513 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "vector.hpp"
+#include "doubly_linked_list.hpp"
+#include "singly_linked_list.hpp"
+
+/*
+ * Latency benchmarks of the orla containers against their std counterparts
+ *
+ * Every benchmark fills a fresh container with size items, then times ops
+ * individual operations on it. The first warmup repetitions are discarded
+ * and the per operation samples of the others are reduced to median, p99
+ * and mean. Samples include the ~20 ns of the two clock reads around each
+ * operation. Operations that grow or shrink the container are undone outside
+ * the timed region, so every sample is taken at size items. Operations that
+ * walk the container run fewer times on large sizes so a run stays in the
+ * range of minutes.
+ */
+
+typedef std::chrono::steady_clock bench_clock;
+
+static const size_t constant_ops  = 1000;
+static const size_t linear_budget = 10000000; /* items touched per repetition by O(n) operations */
+
+enum class output_format
+{
+    csv,
+    json
+};
+
+struct bench_options
+{
+    size_t        min_size;
+    size_t        max_size;
+    size_t        warmup;
+    size_t        reps;
+    output_format format;
+    const char*   filter;
+};
+
+struct bench_result
+{
+    std::string container;
+    std::string operation;
+    size_t      size;
+    size_t      ops;
+    double      median_ns;
+    double      p99_ns;
+    double      mean_ns;
+};
+
+static volatile long long sink;
+
+bool int_comparator(const int& a, const int& b)
+{
+    return a == b;
+}
+
+/* Containers */
+
+template <class C>
+std::unique_ptr<C> make_container(std::true_type)
+{
+    return std::unique_ptr<C>(new C(int_comparator));
+}
+
+template <class C>
+std::unique_ptr<C> make_container(std::false_type)
+{
+    return std::unique_ptr<C>(new C());
+}
+
+/* orla containers take a comparator, std ones are default constructed */
+template <class C>
+std::unique_ptr<C> make_container()
+{
+    return make_container<C>(std::is_constructible<C, bool (*)(const int&, const int&)>{});
+}
+
+void push(orla::vector<int>& c, int value)
+{
+    c.push(value);
+}
+
+template <class C>
+void push(C& c, int value)
+{
+    c.push_back(value);
+}
+
+void pop(orla::vector<int>& c)
+{
+    c.pop();
+}
+
+template <class C>
+void pop(C& c)
+{
+    c.pop_back();
+}
+
+void insert_at(orla::vector<int>& c, size_t index, int value)
+{
+    c.insert(index, value);
+}
+
+void insert_at(orla::singly_linked_list<int>& c, size_t index, int value)
+{
+    c.insert(index, value);
+}
+
+void insert_at(orla::doubly_linked_list<int>& c, size_t index, int value)
+{
+    c.insert(index, value);
+}
+
+void insert_at(std::list<int>& c, size_t index, int value)
+{
+    c.insert(std::next(c.begin(), index), value);
+}
+
+void insert_at(std::forward_list<int>& c, size_t index, int value)
+{
+    c.insert_after(std::next(c.before_begin(), index), value);
+}
+
+template <class C>
+void insert_at(C& c, size_t index, int value)
+{
+    c.insert(c.begin() + index, value);
+}
+
+void prepend(orla::vector<int>& c, int value)
+{
+    c.prepend(value);
+}
+
+template <class C>
+void prepend(C& c, int value)
+{
+    c.insert(c.begin(), value);
+}
+
+void erase_at(orla::vector<int>& c, size_t index)
+{
+    c.erase_at(index);
+}
+
+void erase_at(orla::singly_linked_list<int>& c, size_t index)
+{
+    c.erase(index);
+}
+
+void erase_at(orla::doubly_linked_list<int>& c, size_t index)
+{
+    c.erase(index);
+}
+
+void erase_at(std::list<int>& c, size_t index)
+{
+    c.erase(std::next(c.begin(), index));
+}
+
+void erase_at(std::forward_list<int>& c, size_t index)
+{
+    c.erase_after(std::next(c.before_begin(), index));
+}
+
+template <class C>
+void erase_at(C& c, size_t index)
+{
+    c.erase(c.begin() + index);
+}
+
+long long find(orla::vector<int>& c, int value)
+{
+    return c.find(value);
+}
+
+template <class C>
+long long find(C& c, int value)
+{
+    return std::find(c.begin(), c.end(), value) - c.begin();
+}
+
+void remove(orla::vector<int>& c, int value)
+{
+    c.remove(value);
+}
+
+template <class C>
+void remove(C& c, int value)
+{
+    c.erase(std::remove(c.begin(), c.end(), value), c.end());
+}
+
+template <class C>
+long long pop_front(C& c)
+{
+    return c.pop_front();
+}
+
+long long pop_front(std::list<int>& c)
+{
+    long long ret = c.front();
+    c.pop_front();
+    return ret;
+}
+
+long long pop_front(std::forward_list<int>& c)
+{
+    long long ret = c.front();
+    c.pop_front();
+    return ret;
+}
+
+template <class C>
+long long value_at(C& c, size_t index)
+{
+    return c.value_at(index);
+}
+
+long long value_at(std::list<int>& c, size_t index)
+{
+    return *std::next(c.begin(), index);
+}
+
+long long value_at(std::forward_list<int>& c, size_t index)
+{
+    return *std::next(c.begin(), index);
+}
+
+template <class C>
+void remove_value(C& c, int value)
+{
+    c.remove_value(value);
+}
+
+void remove_value(std::list<int>& c, int value)
+{
+    c.remove(value);
+}
+
+void remove_value(std::forward_list<int>& c, int value)
+{
+    c.remove(value);
+}
+
+/* Harness */
+
+/* Repetitions of an O(n) operation so one repetition touches about linear_budget items */
+size_t linear_ops(const size_t size)
+{
+    size_t ops = linear_budget / size;
+    return ops < 1 ? 1 : ops > constant_ops ? constant_ops : ops;
+}
+
+/* Distinct values of 0..size-1 for the first size draws */
+int spread_value(const size_t i, const size_t size)
+{
+    return (i * 7919 + size / 2) % size;
+}
+
+bool is_selected(const bench_options& options, const char* container, const char* operation)
+{
+    if (!options.filter)
+        return true;
+
+    std::string name = std::string(container) + "/" + operation;
+    return name.find(options.filter) != std::string::npos;
+}
+
+bench_result summarize(const char* container, const char* operation, size_t size, size_t ops, std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0;
+    for (double sample : samples)
+        total += sample;
+
+    size_t p99 = samples.size() * 99 / 100;
+    return bench_result{ container,
+                         operation,
+                         size,
+                         ops,
+                         samples[samples.size() / 2],
+                         samples[p99 < samples.size() ? p99 : samples.size() - 1],
+                         total / samples.size() };
+}
+
+/* Operations that leave the size alone have nothing to undo */
+template <class C>
+void keep_size(C&, size_t, uint64_t)
+{
+}
+
+/*
+ * Fills a fresh container per repetition with fill, then times op(container, i, random) ops times. undo gets the
+ * same arguments right after each op, untimed, and restores the size op changed.
+ */
+template <class C, class Fill, class Op, class Undo>
+void run(const char*                container,
+         const char*                operation,
+         const size_t               size,
+         size_t                     ops,
+         Fill                       fill,
+         Op                         op,
+         Undo                       undo,
+         const bench_options&       options,
+         std::vector<bench_result>& results)
+{
+    if (!ops || !is_selected(options, container, operation))
+        return;
+
+    std::mt19937_64       rng(size);
+    std::vector<uint64_t> random(ops);
+    for (uint64_t& r : random)
+        r = rng();
+
+    std::vector<double> samples;
+    samples.reserve(ops * options.reps);
+
+    for (size_t rep = 0; rep < options.warmup + options.reps; ++rep)
+    {
+        std::unique_ptr<C> c = make_container<C>();
+        fill(*c, size);
+
+        for (size_t i = 0; i < ops; ++i)
+        {
+            bench_clock::time_point start = bench_clock::now();
+            op(*c, i, random[i]);
+            bench_clock::time_point stop = bench_clock::now();
+            undo(*c, i, random[i]);
+
+            if (rep >= options.warmup)
+                samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+    }
+
+    results.push_back(summarize(container, operation, size, ops, samples));
+}
+
+template <class C>
+void fill_vector(C& c, const size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+        push(c, i);
+}
+
+/* Lists are built from the front so forward_list gets the same 0..size-1 order */
+template <class C>
+void fill_list(C& c, const size_t size)
+{
+    for (size_t i = size; i > 0; --i)
+        c.push_front(i - 1);
+}
+
+template <class C>
+void bench_vector(const char* name, const size_t size, const bench_options& options, std::vector<bench_result>& results)
+{
+    size_t linear = linear_ops(size);
+
+    run<C>(name, "push", size, constant_ops, fill_vector<C>,
+           [](C& c, size_t i, uint64_t) { push(c, i); },
+           [](C& c, size_t, uint64_t) { pop(c); }, options, results);
+    run<C>(name, "insert", size, linear, fill_vector<C>,
+           [size](C& c, size_t i, uint64_t r) { insert_at(c, r % (size + 1), i); },
+           [](C& c, size_t, uint64_t) { pop(c); }, options, results);
+    run<C>(name, "prepend", size, linear, fill_vector<C>,
+           [](C& c, size_t i, uint64_t) { prepend(c, i); },
+           [](C& c, size_t, uint64_t) { pop(c); }, options, results);
+    run<C>(name, "erase_at", size, linear, fill_vector<C>,
+           [size](C& c, size_t, uint64_t r) { erase_at(c, r % size); },
+           [](C& c, size_t i, uint64_t) { push(c, i); }, options, results);
+    run<C>(name, "find", size, linear, fill_vector<C>,
+           [size](C& c, size_t, uint64_t r) { sink += find(c, r % size); }, keep_size<C>, options, results);
+    run<C>(name, "remove", size, linear, fill_vector<C>,
+           [size](C& c, size_t i, uint64_t) { remove(c, spread_value(i, size)); },
+           [size](C& c, size_t i, uint64_t) { push(c, spread_value(i, size)); }, options, results);
+}
+
+template <class C>
+void bench_list(const char* name, const size_t size, const bench_options& options, std::vector<bench_result>& results)
+{
+    size_t linear = linear_ops(size);
+
+    run<C>(name, "push", size, constant_ops, fill_list<C>,
+           [](C& c, size_t i, uint64_t) { c.push_front(i); },
+           [](C& c, size_t, uint64_t) { pop_front(c); }, options, results);
+    run<C>(name, "pop", size, constant_ops, fill_list<C>,
+           [](C& c, size_t, uint64_t) { sink += pop_front(c); },
+           [](C& c, size_t i, uint64_t) { c.push_front(i); }, options, results);
+    run<C>(name, "insert", size, linear, fill_list<C>,
+           [size](C& c, size_t i, uint64_t r) { insert_at(c, r % (size + 1), i); },
+           [](C& c, size_t, uint64_t) { pop_front(c); }, options, results);
+    run<C>(name, "erase", size, linear, fill_list<C>,
+           [size](C& c, size_t, uint64_t r) { erase_at(c, r % size); },
+           [](C& c, size_t i, uint64_t) { c.push_front(i); }, options, results);
+    run<C>(name, "value_at", size, linear, fill_list<C>,
+           [size](C& c, size_t, uint64_t r) { sink += value_at(c, r % size); }, keep_size<C>, options, results);
+    run<C>(name, "reverse", size, linear, fill_list<C>,
+           [](C& c, size_t, uint64_t) { c.reverse(); }, keep_size<C>, options, results);
+    run<C>(name, "remove_value", size, linear, fill_list<C>,
+           [size](C& c, size_t i, uint64_t) { remove_value(c, spread_value(i, size)); },
+           [size](C& c, size_t i, uint64_t) { c.push_front(spread_value(i, size)); }, options, results);
+}
+
+void print_results(const std::vector<bench_result>& results, output_format format)
+{
+    if (format == output_format::csv)
+    {
+        printf("container,operation,size,ops,median_ns,p99_ns,mean_ns\n");
+        for (const bench_result& r : results)
+        {
+            printf("%s,%s,%zu,%zu,%.1f,%.1f,%.1f\n", r.container.c_str(), r.operation.c_str(), r.size, r.ops,
+                   r.median_ns, r.p99_ns, r.mean_ns);
+        }
+        return;
+    }
+
+    printf("[\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const bench_result& r = results[i];
+        printf("  {\"container\": \"%s\", \"operation\": \"%s\", \"size\": %zu, \"ops\": %zu, "
+               "\"median_ns\": %.1f, \"p99_ns\": %.1f, \"mean_ns\": %.1f}%s\n",
+               r.container.c_str(), r.operation.c_str(), r.size, r.ops, r.median_ns, r.p99_ns, r.mean_ns,
+               i + 1 < results.size() ? "," : "");
+    }
+    printf("]\n");
+}
+
+void usage(const char* program)
+{
+    fprintf(stderr,
+            "usage: %s [--min-size N] [--max-size N] [--warmup N] [--reps N]\n"
+            "          [--format csv|json] [--filter container/operation]\n"
+            "Sizes go from min to max by factors of ten, defaults 10 and 10000000.\n",
+            program);
+}
+
+bool parse_options(int argc, char** argv, bench_options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--help"))
+            return false;
+        if (i + 1 >= argc)
+            return false;
+
+        const char* value = argv[++i];
+        if (!strcmp(argv[i - 1], "--min-size"))
+            options.min_size = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--max-size"))
+            options.max_size = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--warmup"))
+            options.warmup = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--reps"))
+            options.reps = strtoull(value, nullptr, 10);
+        else if (!strcmp(argv[i - 1], "--filter"))
+            options.filter = value;
+        else if (!strcmp(argv[i - 1], "--format") && !strcmp(value, "csv"))
+            options.format = output_format::csv;
+        else if (!strcmp(argv[i - 1], "--format") && !strcmp(value, "json"))
+            options.format = output_format::json;
+        else
+            return false;
+    }
+
+    return options.min_size && options.reps && options.min_size <= options.max_size;
+}
+
+int main(int argc, char** argv)
+{
+    bench_options options{ 10, 10000000, 1, 5, output_format::csv, nullptr };
+    if (!parse_options(argc, argv, options))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<bench_result> results;
+    for (size_t size = options.min_size; size <= options.max_size; size *= 10)
+    {
+        bench_vector<orla::vector<int>>("orla::vector", size, options, results);
+        bench_vector<std::vector<int>>("std::vector", size, options, results);
+        bench_vector<std::deque<int>>("std::deque", size, options, results);
+
+        bench_list<orla::singly_linked_list<int>>("orla::singly_linked_list", size, options, results);
+        bench_list<orla::doubly_linked_list<int>>("orla::doubly_linked_list", size, options, results);
+        bench_list<std::list<int>>("std::list", size, options, results);
+        bench_list<std::forward_list<int>>("std::forward_list", size, options, results);
+
+        fprintf(stderr, "size %zu done\n", size);
+        if (size > options.max_size / 10)
+            break;
+    }
+
+    print_results(results, options.format);
+    return 0;
+}
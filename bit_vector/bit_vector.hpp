@@ -0,0 +1,407 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include "vector.hpp"
+
+namespace orla
+{
+
+/* Bits per rank superblock and set bits per select sample */
+static const size_t bit_vector_superblock_bits = 512;
+static const size_t bit_vector_select_sample   = 512;
+
+/**
+ * bit_vector - vector of bools packed 64 to a word
+ *
+ * Bits live in the uint64_t words of an orla::vector, the unused high bits
+ * of the last word kept at zero so whole words can be counted and combined.
+ * count() and the rank and select queries use __builtin_popcountll, a
+ * single instruction on targets with POPCNT. The logical operations and
+ * insert() and erase_at() shift work a word at a time.
+ *
+ * build_rank_index() adds one cumulative count per 512-bit superblock,
+ * 1/8 bit per bit, which makes rank() O(1): a lookup plus at most seven
+ * word popcounts. It also samples the superblock of every 512th set bit,
+ * so select() binary searches only between two samples. Any mutation drops
+ * the index; rank() and select() then scan the words from the start.
+ */
+class bit_vector
+{
+public:
+    bit_vector();
+    bit_vector(const bit_vector& vector) = delete;
+
+    size_t size();
+    bool   is_empty();
+    size_t bytes();
+
+    bool   at(const size_t index);
+    void   set(const size_t index, const bool value);
+    void   push(const bool value);
+    bool   pop();
+    void   insert(const size_t index, const bool value);
+    void   erase_at(const size_t index);
+    size_t count();
+    size_t find_first_set();
+    size_t find_next_set(const size_t index);
+
+    void and_with(bit_vector& other);
+    void or_with(bit_vector& other);
+    void xor_with(bit_vector& other);
+    void and_not_with(bit_vector& other);
+
+    void   build_rank_index();
+    bool   has_rank_index();
+    size_t rank(const size_t index);
+    size_t select(const size_t n);
+
+private:
+    /* data */
+    typedef vector<uint64_t, default_allocator<uint64_t>, null_stats, unchecked_bounds> words_t;
+
+    words_t m_words;
+    words_t m_ranks;   /* set bits before each superblock, and in total */
+    words_t m_samples; /* superblock holding set bit k * bit_vector_select_sample */
+    size_t  m_size;
+    bool    m_indexed;
+
+    /* functions */
+    void          resize_words(const size_t size);
+    void          check_same_size(bit_vector& other);
+    size_t        find_set_from(const size_t index);
+    void          drop_rank_index();
+    static size_t select_in_word(uint64_t word, size_t n);
+    static bool   word_comparator(const uint64_t& a, const uint64_t& b);
+};
+
+inline bit_vector::bit_vector()
+    : m_words{ word_comparator }
+    , m_ranks{ word_comparator }
+    , m_samples{ word_comparator }
+    , m_size{ 0 }
+    , m_indexed{ false }
+{
+}
+
+inline size_t bit_vector::size()
+{
+    return m_size;
+}
+
+inline bool bit_vector::is_empty()
+{
+    return !m_size;
+}
+
+inline size_t bit_vector::bytes()
+{
+    return (m_words.size() + m_ranks.size() + m_samples.size()) * sizeof(uint64_t);
+}
+
+inline bool bit_vector::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return (m_words[index / 64] >> (index % 64)) & 1;
+}
+
+inline void bit_vector::set(const size_t index, const bool value)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    uint64_t bit = 1ULL << (index % 64);
+    if (value)
+        m_words[index / 64] |= bit;
+    else
+        m_words[index / 64] &= ~bit;
+
+    drop_rank_index();
+}
+
+inline void bit_vector::push(const bool value)
+{
+    resize_words(m_size + 1);
+    m_size++;
+    set(m_size - 1, value);
+}
+
+inline bool bit_vector::pop()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    bool ret = at(m_size - 1);
+    set(m_size - 1, false);
+    m_size--;
+
+    resize_words(m_size);
+    return ret;
+}
+
+/* Shifts the bits from index on up by one, a word at a time */
+inline void bit_vector::insert(const size_t index, const bool value)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    resize_words(m_size + 1);
+    m_size++;
+
+    size_t   first = index / 64;
+    uint64_t low   = (1ULL << (index % 64)) - 1;
+    for (size_t i = m_words.size() - 1; i > first; --i)
+        m_words[i] = (m_words[i] << 1) | (m_words[i - 1] >> 63);
+    m_words[first] = (m_words[first] & low) | ((m_words[first] & ~low) << 1);
+
+    set(index, value);
+}
+
+inline void bit_vector::erase_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to delete item.");
+
+    size_t   first = index / 64;
+    size_t   last  = m_words.size() - 1;
+    uint64_t low   = (1ULL << (index % 64)) - 1;
+    m_words[first] = (m_words[first] & low) | ((m_words[first] >> 1) & ~low);
+    for (size_t i = first; i < last; ++i)
+    {
+        m_words[i] |= m_words[i + 1] << 63;
+        m_words[i + 1] >>= 1;
+    }
+
+    m_size--;
+    resize_words(m_size);
+    drop_rank_index();
+}
+
+inline size_t bit_vector::count()
+{
+    if (m_indexed)
+        return m_ranks[m_ranks.size() - 1];
+
+    size_t total = 0;
+    for (size_t i = 0; i < m_words.size(); ++i)
+        total += __builtin_popcountll(m_words[i]);
+
+    return total;
+}
+
+/* Index of the first set bit, size() when none is set */
+inline size_t bit_vector::find_first_set()
+{
+    return find_set_from(0);
+}
+
+/* Index of the first set bit after index, size() when there is none */
+inline size_t bit_vector::find_next_set(const size_t index)
+{
+    return find_set_from(index + 1);
+}
+
+inline void bit_vector::and_with(bit_vector& other)
+{
+    check_same_size(other);
+
+    uint64_t*       words  = m_words.data();
+    const uint64_t* others = other.m_words.data();
+    for (size_t i = 0; i < m_words.size(); ++i)
+        words[i] &= others[i];
+
+    drop_rank_index();
+}
+
+inline void bit_vector::or_with(bit_vector& other)
+{
+    check_same_size(other);
+
+    uint64_t*       words  = m_words.data();
+    const uint64_t* others = other.m_words.data();
+    for (size_t i = 0; i < m_words.size(); ++i)
+        words[i] |= others[i];
+
+    drop_rank_index();
+}
+
+inline void bit_vector::xor_with(bit_vector& other)
+{
+    check_same_size(other);
+
+    uint64_t*       words  = m_words.data();
+    const uint64_t* others = other.m_words.data();
+    for (size_t i = 0; i < m_words.size(); ++i)
+        words[i] ^= others[i];
+
+    drop_rank_index();
+}
+
+/* Clears the bits set in other */
+inline void bit_vector::and_not_with(bit_vector& other)
+{
+    check_same_size(other);
+
+    uint64_t*       words  = m_words.data();
+    const uint64_t* others = other.m_words.data();
+    for (size_t i = 0; i < m_words.size(); ++i)
+        words[i] &= ~others[i];
+
+    drop_rank_index();
+}
+
+inline void bit_vector::build_rank_index()
+{
+    drop_rank_index();
+
+    size_t words_per_superblock = bit_vector_superblock_bits / 64;
+    size_t total                = 0;
+    for (size_t i = 0; i < m_words.size(); ++i)
+    {
+        if (!(i % words_per_superblock))
+            m_ranks.push(total);
+        total += __builtin_popcountll(m_words[i]);
+    }
+    m_ranks.push(total);
+
+    /* The last entry of m_ranks is the total, so superblocks are m_ranks.size() - 1 */
+    size_t superblock = 0;
+    for (size_t sample = 0; sample < total; sample += bit_vector_select_sample)
+    {
+        while (m_ranks[superblock + 1] <= sample)
+            superblock++;
+        m_samples.push(superblock);
+    }
+
+    m_indexed = true;
+}
+
+inline bool bit_vector::has_rank_index()
+{
+    return m_indexed;
+}
+
+/* Number of set bits in [0, index) */
+inline size_t bit_vector::rank(const size_t index)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index");
+
+    size_t words_per_superblock = bit_vector_superblock_bits / 64;
+    size_t word                 = 0;
+    size_t ret                  = 0;
+    if (m_indexed)
+    {
+        word = index / bit_vector_superblock_bits * words_per_superblock;
+        ret  = m_ranks[index / bit_vector_superblock_bits];
+    }
+
+    for (; word < index / 64; ++word)
+        ret += __builtin_popcountll(m_words[word]);
+
+    if (index % 64)
+        ret += __builtin_popcountll(m_words[word] & ((1ULL << (index % 64)) - 1));
+
+    return ret;
+}
+
+/* Index of the set bit with rank n, counting from zero, size() when fewer are set */
+inline size_t bit_vector::select(const size_t n)
+{
+    size_t words_per_superblock = bit_vector_superblock_bits / 64;
+    size_t word                 = 0;
+    size_t left                 = n;
+    if (m_indexed)
+    {
+        if (n >= count())
+            return m_size;
+
+        /* The superblock holding bit n lies between this sample and the next */
+        size_t sample = n / bit_vector_select_sample;
+        size_t low    = m_samples[sample];
+        size_t high   = sample + 1 < m_samples.size() ? m_samples[sample + 1] : m_ranks.size() - 2;
+        while (low < high)
+        {
+            size_t middle = low + (high - low + 1) / 2;
+            if (m_ranks[middle] <= n)
+                low = middle;
+            else
+                high = middle - 1;
+        }
+
+        word = low * words_per_superblock;
+        left = n - m_ranks[low];
+    }
+
+    for (; word < m_words.size(); ++word)
+    {
+        size_t bits = __builtin_popcountll(m_words[word]);
+        if (left < bits)
+            return word * 64 + select_in_word(m_words[word], left);
+        left -= bits;
+    }
+
+    return m_size;
+}
+
+/* Keeps exactly the words holding size bits */
+inline void bit_vector::resize_words(const size_t size)
+{
+    size_t words = (size + 63) / 64;
+    while (m_words.size() < words)
+        m_words.push(0);
+    while (m_words.size() > words)
+        m_words.pop_unchecked();
+}
+
+inline void bit_vector::check_same_size(bit_vector& other)
+{
+    if (other.m_size != m_size)
+        throw std::invalid_argument("Bit vectors differ in size");
+}
+
+inline size_t bit_vector::find_set_from(const size_t index)
+{
+    if (index >= m_size)
+        return m_size;
+
+    size_t   word = index / 64;
+    uint64_t bits = m_words[word] & (~0ULL << (index % 64));
+    while (!bits)
+    {
+        if (++word == m_words.size())
+            return m_size;
+        bits = m_words[word];
+    }
+
+    return word * 64 + __builtin_ctzll(bits);
+}
+
+inline void bit_vector::drop_rank_index()
+{
+    if (!m_indexed)
+        return;
+
+    m_ranks.clear();
+    m_samples.clear();
+    m_indexed = false;
+}
+
+/* Position of the set bit of word with rank n, which must exist */
+inline size_t bit_vector::select_in_word(uint64_t word, size_t n)
+{
+    for (; n; --n)
+        word &= word - 1;
+
+    return __builtin_ctzll(word);
+}
+
+inline bool bit_vector::word_comparator(const uint64_t& a, const uint64_t& b)
+{
+    return a == b;
+}
+
+} // namespace orla
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace orla
+{
+
+/* Returned by the try_* accessors, which report bad indices and empty containers instead of throwing */
+enum class access_error
+{
+    none,
+    out_of_range,
+    empty
+};
+
+/**
+ * checked_bounds - default bounds policy of vector, the linked lists and static_vector
+ *
+ * Containers hand the index and emptiness preconditions of at(), value_at(),
+ * front(), back(), the pops, insert() and erase() to the static hooks of
+ * their Bounds policy. checked_bounds throws std::out_of_range for a bad
+ * index and std::logic_error for an empty container. The throws live in
+ * cold out of line functions, so the inlined check is a single branch.
+ * The hooks are constexpr, so constexpr containers can call them too.
+ */
+struct checked_bounds
+{
+    static constexpr void check_index(const bool valid, const char* message);
+    static constexpr void check_not_empty(const bool valid, const char* message);
+};
+
+/* debug_bounds - asserts the preconditions, so NDEBUG builds check nothing */
+struct debug_bounds
+{
+    static constexpr void check_index(const bool valid, const char* message);
+    static constexpr void check_not_empty(const bool valid, const char* message);
+};
+
+/**
+ * unchecked_bounds - trusts the caller in every build
+ *
+ * The hooks are empty, leaving hot loops without branches into throw paths.
+ * A violated precondition is undefined behaviour.
+ *
+ *     orla::vector<int, orla::default_allocator<int>, orla::null_stats, orla::unchecked_bounds> v(cmp);
+ */
+struct unchecked_bounds
+{
+    static constexpr void check_index(const bool valid, const char* message);
+    static constexpr void check_not_empty(const bool valid, const char* message);
+};
+
+/* abort_bounds - calls std::abort() on a violated precondition, for code that must not throw */
+struct abort_bounds
+{
+    static constexpr void check_index(const bool valid, const char* message);
+    static constexpr void check_not_empty(const bool valid, const char* message);
+};
+
+namespace detail
+{
+
+[[noreturn]] __attribute__((noinline, cold)) inline void throw_out_of_range(const char* message)
+{
+    throw std::out_of_range(message);
+}
+
+[[noreturn]] __attribute__((noinline, cold)) inline void throw_empty(const char* message)
+{
+    throw std::logic_error(message);
+}
+
+} // namespace detail
+
+inline constexpr void checked_bounds::check_index(const bool valid, const char* message)
+{
+    if (__builtin_expect(!valid, 0))
+        detail::throw_out_of_range(message);
+}
+
+inline constexpr void checked_bounds::check_not_empty(const bool valid, const char* message)
+{
+    if (__builtin_expect(!valid, 0))
+        detail::throw_empty(message);
+}
+
+inline constexpr void debug_bounds::check_index(const bool valid, const char* message)
+{
+    assert(valid && message);
+    (void)valid;
+    (void)message;
+}
+
+inline constexpr void debug_bounds::check_not_empty(const bool valid, const char* message)
+{
+    assert(valid && message);
+    (void)valid;
+    (void)message;
+}
+
+inline constexpr void unchecked_bounds::check_index(const bool, const char*)
+{
+}
+
+inline constexpr void unchecked_bounds::check_not_empty(const bool, const char*)
+{
+}
+
+inline constexpr void abort_bounds::check_index(const bool valid, const char*)
+{
+    if (__builtin_expect(!valid, 0))
+        std::abort();
+}
+
+inline constexpr void abort_bounds::check_not_empty(const bool valid, const char*)
+{
+    if (__builtin_expect(!valid, 0))
+        std::abort();
+}
+
+} // namespace orla
@@ -0,0 +1,731 @@
+#pragma once
+
+#if __cplusplus < 202002L
+#error "orla::channel requires C++20 coroutines"
+#endif
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include "doubly_linked_list.hpp"
+#include "vector.hpp"
+
+namespace orla
+{
+
+class scheduler;
+
+/**
+ * task - fire-and-forget coroutine driven by a scheduler
+ *
+ * A task starts suspended and only runs once handed to scheduler::spawn().
+ * Its frame is destroyed when the coroutine body finishes.
+ */
+class task
+{
+public:
+    struct promise_type;
+    typedef std::coroutine_handle<promise_type> handle_t;
+
+    struct final_awaiter
+    {
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+        void await_suspend(handle_t handle) noexcept;
+        void await_resume() noexcept {}
+    };
+
+    struct promise_type
+    {
+        scheduler* m_scheduler = nullptr;
+
+        task get_return_object()
+        {
+            return task(handle_t::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        final_awaiter final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+    };
+
+    task(task&& other) noexcept;
+    task(const task& other) = delete;
+    ~task();
+
+private:
+    friend class scheduler;
+
+    explicit task(handle_t handle);
+
+    handle_t m_handle;
+};
+
+class scheduler
+{
+public:
+    virtual ~scheduler() = default;
+
+    void         spawn(task&& t);
+    virtual void post(std::coroutine_handle<> handle) = 0;
+
+protected:
+    friend struct task::final_awaiter;
+
+    virtual void task_started()  = 0;
+    virtual void task_finished() = 0;
+
+    static bool handle_comparator(const std::coroutine_handle<>& a, const std::coroutine_handle<>& b)
+    {
+        return a == b;
+    }
+};
+
+/**
+ * single_thread_scheduler - runs every posted coroutine on the thread calling run()
+ *
+ * run() returns once the run queue is empty, i.e. every task either finished or
+ * is parked on a channel. post() may be called from any thread, so a task woken
+ * by a task of another scheduler waits in the run queue for the next run().
+ * Frames still queued when the scheduler is destroyed are destroyed with it.
+ */
+class single_thread_scheduler : public scheduler
+{
+public:
+    single_thread_scheduler();
+    single_thread_scheduler(const single_thread_scheduler& sched) = delete;
+    ~single_thread_scheduler();
+
+    void   post(std::coroutine_handle<> handle) override;
+    void   run();
+    size_t pending_tasks();
+
+protected:
+    void task_started() override;
+    void task_finished() override;
+
+private:
+    /* data */
+    doubly_linked_list<std::coroutine_handle<>> m_queue;
+    size_t                                      m_outstanding;
+    std::mutex                                  m_mutex;
+};
+
+/**
+ * thread_pool_scheduler - runs posted coroutines on a fixed number of threads
+ *
+ * run() blocks the caller, which acts as one of the workers, until every task
+ * finished or every worker is idle with an empty run queue. Frames still queued
+ * when the scheduler is destroyed are destroyed with it.
+ */
+class thread_pool_scheduler : public scheduler
+{
+public:
+    thread_pool_scheduler(const size_t threads);
+    thread_pool_scheduler(const thread_pool_scheduler& sched) = delete;
+    ~thread_pool_scheduler();
+
+    void   post(std::coroutine_handle<> handle) override;
+    void   run();
+    size_t pending_tasks();
+
+protected:
+    void task_started() override;
+    void task_finished() override;
+
+private:
+    /* data */
+    doubly_linked_list<std::coroutine_handle<>> m_queue;
+    size_t                                      m_threads;
+    size_t                                      m_idle;
+    size_t                                      m_outstanding;
+    bool                                        m_stopping;
+    std::mutex                                  m_mutex;
+    std::condition_variable                     m_ready;
+
+    /* functions */
+    void worker();
+};
+
+/**
+ * channel - bounded multi-producer multi-consumer queue for tasks
+ *
+ * Senders suspend while the buffer holds capacity() items and receivers
+ * suspend while it is empty. A suspended task is resumed through the
+ * scheduler it was spawned on, so a channel may connect tasks of different
+ * schedulers. A capacity of zero makes every send a rendezvous.
+ *
+ * A parked task belongs to the channel until it is woken. Closing or
+ * destroying the channel posts every parked task back to its scheduler,
+ * which runs or destroys it, so a channel must not outlive the schedulers
+ * of the tasks parked on it.
+ */
+template <class T>
+class channel
+{
+public:
+    class send_awaiter;
+    class receive_awaiter;
+    class batch_receive_awaiter;
+
+    channel(const size_t capacity);
+    channel(const channel& ch) = delete;
+    ~channel();
+
+    size_t capacity();
+    size_t size();
+    bool   is_closed();
+
+    send_awaiter          send(const T& item);
+    receive_awaiter       receive();
+    batch_receive_awaiter receive_batch(vector<T>& out, const size_t max_items);
+    void                  close();
+
+private:
+    /* data */
+    typedef struct waiter
+    {
+        task::handle_t   handle;
+        const T*         item;
+        std::optional<T> received;
+        bool             delivered;
+    } waiter_t;
+
+    size_t                        m_capacity;
+    bool                          m_closed;
+    doubly_linked_list<T>         m_items;
+    doubly_linked_list<waiter_t*> m_senders;
+    doubly_linked_list<waiter_t*> m_receivers;
+    std::mutex                    m_mutex;
+
+    /* functions */
+    static bool item_comparator(const T& a, const T& b);
+    static bool waiter_comparator(waiter_t* const& a, waiter_t* const& b);
+    static void wake(waiter_t* w);
+
+    bool try_send(const T& item, waiter_t** woken);
+    bool try_receive(std::optional<T>& out, waiter_t** woken);
+};
+
+template <class T>
+class channel<T>::send_awaiter
+{
+public:
+    bool await_ready()
+    {
+        return false;
+    }
+    bool await_suspend(task::handle_t handle);
+    bool await_resume()
+    {
+        return m_waiter.delivered;
+    }
+
+private:
+    friend class channel<T>;
+
+    send_awaiter(channel<T>& ch, const T& item)
+        : m_channel{ ch }
+        , m_item{ item }
+        , m_waiter{}
+    {
+    }
+
+    channel<T>& m_channel;
+    T           m_item;
+    waiter_t    m_waiter;
+};
+
+template <class T>
+class channel<T>::receive_awaiter
+{
+public:
+    bool await_ready()
+    {
+        return false;
+    }
+    bool             await_suspend(task::handle_t handle);
+    std::optional<T> await_resume()
+    {
+        return std::move(m_waiter.received);
+    }
+
+private:
+    friend class channel<T>;
+
+    receive_awaiter(channel<T>& ch)
+        : m_channel{ ch }
+        , m_waiter{}
+    {
+    }
+
+    channel<T>& m_channel;
+    waiter_t    m_waiter;
+};
+
+template <class T>
+class channel<T>::batch_receive_awaiter
+{
+public:
+    bool await_ready()
+    {
+        return false;
+    }
+    bool   await_suspend(task::handle_t handle);
+    size_t await_resume();
+
+private:
+    friend class channel<T>;
+
+    batch_receive_awaiter(channel<T>& ch, vector<T>& out, const size_t max_items)
+        : m_channel{ ch }
+        , m_out{ out }
+        , m_max_items{ max_items }
+        , m_received{ 0 }
+        , m_waiter{}
+    {
+    }
+
+    channel<T>& m_channel;
+    vector<T>&  m_out;
+    size_t      m_max_items;
+    size_t      m_received;
+    waiter_t    m_waiter;
+
+    void drain();
+};
+
+inline task::task(handle_t handle)
+    : m_handle{ handle }
+{
+}
+
+inline task::task(task&& other) noexcept
+    : m_handle{ other.m_handle }
+{
+    other.m_handle = nullptr;
+}
+
+inline task::~task()
+{
+    if (m_handle)
+        m_handle.destroy();
+}
+
+inline void task::final_awaiter::await_suspend(handle_t handle) noexcept
+{
+    scheduler* sched = handle.promise().m_scheduler;
+    handle.destroy();
+    sched->task_finished();
+}
+
+inline void scheduler::spawn(task&& t)
+{
+    task::handle_t handle = t.m_handle;
+    if (!handle)
+        throw std::invalid_argument("Cannot spawn an empty task");
+
+    t.m_handle                    = nullptr;
+    handle.promise().m_scheduler = this;
+    task_started();
+    post(handle);
+}
+
+inline single_thread_scheduler::single_thread_scheduler()
+    : m_queue{ handle_comparator }
+    , m_outstanding{ 0 }
+{
+}
+
+inline single_thread_scheduler::~single_thread_scheduler()
+{
+    while (!m_queue.is_empty())
+        m_queue.pop_front().destroy();
+}
+
+inline void single_thread_scheduler::post(std::coroutine_handle<> handle)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(handle);
+}
+
+inline void single_thread_scheduler::run()
+{
+    for (;;)
+    {
+        std::coroutine_handle<> handle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_queue.is_empty())
+                return;
+            handle = m_queue.pop_front();
+        }
+        handle.resume();
+    }
+}
+
+inline size_t single_thread_scheduler::pending_tasks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_outstanding;
+}
+
+inline void single_thread_scheduler::task_started()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outstanding++;
+}
+
+inline void single_thread_scheduler::task_finished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outstanding--;
+}
+
+inline thread_pool_scheduler::thread_pool_scheduler(const size_t threads)
+    : m_queue{ handle_comparator }
+    , m_threads{ threads }
+    , m_idle{ 0 }
+    , m_outstanding{ 0 }
+    , m_stopping{ false }
+{
+    if (!m_threads)
+        throw std::invalid_argument("Thread pool needs at least one thread");
+}
+
+inline thread_pool_scheduler::~thread_pool_scheduler()
+{
+    while (!m_queue.is_empty())
+        m_queue.pop_front().destroy();
+}
+
+inline void thread_pool_scheduler::post(std::coroutine_handle<> handle)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(handle);
+    }
+    m_ready.notify_one();
+}
+
+inline void thread_pool_scheduler::run()
+{
+    std::unique_ptr<std::thread[]> workers(new std::thread[m_threads - 1]);
+    for (size_t i = 0; i < m_threads - 1; ++i)
+        workers[i] = std::thread(&thread_pool_scheduler::worker, this);
+
+    worker();
+
+    for (size_t i = 0; i < m_threads - 1; ++i)
+        workers[i].join();
+
+    m_stopping = false;
+}
+
+inline size_t thread_pool_scheduler::pending_tasks()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_outstanding;
+}
+
+inline void thread_pool_scheduler::task_started()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_outstanding++;
+}
+
+inline void thread_pool_scheduler::task_finished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!--m_outstanding)
+        m_ready.notify_all();
+}
+
+inline void thread_pool_scheduler::worker()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping)
+    {
+        if (!m_queue.is_empty())
+        {
+            std::coroutine_handle<> handle = m_queue.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+            continue;
+        }
+
+        /* Nothing runnable and no other worker can post: every task is done or parked */
+        if (!m_outstanding || m_idle + 1 == m_threads)
+        {
+            m_stopping = true;
+            m_ready.notify_all();
+            break;
+        }
+
+        m_idle++;
+        m_ready.wait(lock);
+        m_idle--;
+    }
+}
+
+template <class T>
+channel<T>::channel(const size_t capacity)
+    : m_capacity{ capacity }
+    , m_closed{ false }
+    , m_items{ item_comparator }
+    , m_senders{ waiter_comparator }
+    , m_receivers{ waiter_comparator }
+{
+}
+
+template <class T>
+channel<T>::~channel()
+{
+    close();
+}
+
+template <class T>
+size_t channel<T>::capacity()
+{
+    return m_capacity;
+}
+
+template <class T>
+size_t channel<T>::size()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_items.size();
+}
+
+template <class T>
+bool channel<T>::is_closed()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_closed;
+}
+
+template <class T>
+typename channel<T>::send_awaiter channel<T>::send(const T& item)
+{
+    return send_awaiter(*this, item);
+}
+
+template <class T>
+typename channel<T>::receive_awaiter channel<T>::receive()
+{
+    return receive_awaiter(*this);
+}
+
+template <class T>
+typename channel<T>::batch_receive_awaiter channel<T>::receive_batch(vector<T>& out, const size_t max_items)
+{
+    if (!max_items)
+        throw std::invalid_argument("Batch size cannot be zero");
+
+    return batch_receive_awaiter(*this, out, max_items);
+}
+
+template <class T>
+void channel<T>::close()
+{
+    doubly_linked_list<waiter_t*> woken(waiter_comparator);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        while (!m_senders.is_empty())
+            woken.push_back(m_senders.pop_front());
+        while (!m_receivers.is_empty())
+            woken.push_back(m_receivers.pop_front());
+    }
+
+    while (!woken.is_empty())
+        wake(woken.pop_front());
+}
+
+template <class T>
+bool channel<T>::item_comparator(const T&, const T&)
+{
+    return false;
+}
+
+template <class T>
+bool channel<T>::waiter_comparator(waiter_t* const& a, waiter_t* const& b)
+{
+    return a == b;
+}
+
+template <class T>
+void channel<T>::wake(waiter_t* w)
+{
+    /* w lives in the suspended frame and may be gone as soon as it is posted */
+    task::handle_t handle = w->handle;
+    handle.promise().m_scheduler->post(handle);
+}
+
+template <class T>
+bool channel<T>::try_send(const T& item, waiter_t** woken)
+{
+    if (!m_receivers.is_empty())
+    {
+        waiter_t* receiver = m_receivers.pop_front();
+        receiver->received = item;
+        *woken             = receiver;
+        return true;
+    }
+
+    if (m_items.size() < m_capacity)
+    {
+        m_items.push_back(item);
+        return true;
+    }
+
+    return false;
+}
+
+template <class T>
+bool channel<T>::try_receive(std::optional<T>& out, waiter_t** woken)
+{
+    if (!m_items.is_empty())
+    {
+        out = m_items.pop_front();
+        if (!m_senders.is_empty())
+        {
+            waiter_t* sender = m_senders.pop_front();
+            m_items.push_back(*sender->item);
+            sender->delivered = true;
+            *woken            = sender;
+        }
+        return true;
+    }
+
+    if (!m_senders.is_empty())
+    {
+        waiter_t* sender  = m_senders.pop_front();
+        out               = *sender->item;
+        sender->delivered = true;
+        *woken            = sender;
+        return true;
+    }
+
+    return false;
+}
+
+template <class T>
+bool channel<T>::send_awaiter::await_suspend(task::handle_t handle)
+{
+    waiter_t* woken = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+        if (m_channel.m_closed)
+        {
+            m_waiter.delivered = false;
+            return false;
+        }
+
+        if (!m_channel.try_send(m_item, &woken))
+        {
+            m_waiter.handle    = handle;
+            m_waiter.item      = &m_item;
+            m_waiter.delivered = false;
+            m_channel.m_senders.push_back(&m_waiter);
+            return true;
+        }
+        m_waiter.delivered = true;
+    }
+
+    if (woken)
+        wake(woken);
+
+    return false;
+}
+
+template <class T>
+bool channel<T>::receive_awaiter::await_suspend(task::handle_t handle)
+{
+    waiter_t* woken = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+        if (!m_channel.try_receive(m_waiter.received, &woken))
+        {
+            if (m_channel.m_closed)
+                return false;
+
+            m_waiter.handle = handle;
+            m_channel.m_receivers.push_back(&m_waiter);
+            return true;
+        }
+    }
+
+    if (woken)
+        wake(woken);
+
+    return false;
+}
+
+template <class T>
+bool channel<T>::batch_receive_awaiter::await_suspend(task::handle_t handle)
+{
+    std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+    drain();
+    if (m_received || m_channel.m_closed)
+        return false;
+
+    m_waiter.handle = handle;
+    m_channel.m_receivers.push_back(&m_waiter);
+    return true;
+}
+
+template <class T>
+size_t channel<T>::batch_receive_awaiter::await_resume()
+{
+    if (m_waiter.received)
+    {
+        m_out.push(*m_waiter.received);
+        m_received++;
+        m_waiter.received.reset();
+
+        std::lock_guard<std::mutex> lock(m_channel.m_mutex);
+        drain();
+    }
+
+    return m_received;
+}
+
+template <class T>
+void channel<T>::batch_receive_awaiter::drain()
+{
+    /* Called with the channel locked so the whole batch costs one acquisition */
+    std::optional<T> item;
+    while (m_received < m_max_items)
+    {
+        waiter_t* woken = nullptr;
+        if (!m_channel.try_receive(item, &woken))
+            break;
+
+        if (woken)
+            wake(woken);
+
+        m_out.push(*item);
+        m_received++;
+    }
+}
+
+} // namespace orla
@@ -0,0 +1,341 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace orla
+{
+
+static const uint32_t compact_list_npos             = UINT32_MAX;
+static const uint32_t initial_compact_list_capacity = 16;
+
+/**
+ * compact_list - doubly linked list whose nodes live in one growable pool
+ *
+ * Links are 32-bit pool indices instead of pointers, halving the per-node
+ * link overhead of doubly_linked_list on 64-bit targets and dropping the
+ * per-node allocation. Erased nodes go on a free list threaded through next
+ * and are reused first. The pool doubles when exhausted and never shrinks;
+ * it holds at most compact_list_npos - 1 items.
+ */
+template <class T>
+class compact_list
+{
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    compact_list(item_comparator comparator);
+    compact_list(const compact_list& list) = delete;
+    ~compact_list();
+
+    size_t size();
+    size_t capacity();
+    bool   is_empty();
+    T&     value_at(const size_t index);
+    void   push_front(const T& value);
+    T      pop_front();
+    void   push_back(const T& value);
+    T      pop_back();
+    T&     front();
+    T&     back();
+    void   insert(const size_t index, const T& value);
+    void   erase(const size_t index);
+    T&     value_n_from_end(const size_t n);
+    void   reverse();
+    void   remove_value(const T& value);
+
+private:
+    /* data */
+    typedef struct node
+    {
+        T        item;
+        uint32_t next;
+        uint32_t prev;
+    } node_t;
+
+    uint32_t        m_size;
+    uint32_t        m_head;
+    uint32_t        m_tail;
+    uint32_t        m_free;
+    uint32_t        m_used;
+    uint32_t        m_capacity;
+    node_t*         m_pool;
+    item_comparator m_comparator;
+
+    /* functions */
+    uint32_t node_at(const size_t index);
+    uint32_t allocate_node(const T& value);
+    void     link_before(const uint32_t index, const uint32_t next);
+    void     remove_node(const uint32_t index);
+    void     grow();
+};
+
+template <class T>
+compact_list<T>::compact_list(item_comparator comparator)
+    : m_size{ 0 }
+    , m_head{ compact_list_npos }
+    , m_tail{ compact_list_npos }
+    , m_free{ compact_list_npos }
+    , m_used{ 0 }
+    , m_capacity{ initial_compact_list_capacity }
+    , m_pool{ nullptr }
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+    {
+        throw std::invalid_argument("Comparator cannot be null");
+    }
+    m_pool = new node_t[m_capacity];
+}
+
+template <class T>
+compact_list<T>::~compact_list()
+{
+    if (m_pool)
+        delete[] m_pool;
+}
+
+template <class T>
+size_t compact_list<T>::size()
+{
+    return m_size;
+}
+
+template <class T>
+size_t compact_list<T>::capacity()
+{
+    return m_capacity;
+}
+
+template <class T>
+bool compact_list<T>::is_empty()
+{
+    return !m_size;
+}
+
+template <class T>
+T& compact_list<T>::value_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return m_pool[node_at(index)].item;
+}
+
+template <class T>
+void compact_list<T>::push_front(const T& value)
+{
+    link_before(allocate_node(value), m_head);
+}
+
+template <class T>
+T compact_list<T>::pop_front()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty list");
+
+    T ret = m_pool[m_head].item;
+    remove_node(m_head);
+    return ret;
+}
+
+template <class T>
+void compact_list<T>::push_back(const T& value)
+{
+    link_before(allocate_node(value), compact_list_npos);
+}
+
+template <class T>
+T compact_list<T>::pop_back()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty list");
+
+    T ret = m_pool[m_tail].item;
+    remove_node(m_tail);
+    return ret;
+}
+
+template <class T>
+T& compact_list<T>::front()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot get front item from an empty list");
+
+    return m_pool[m_head].item;
+}
+
+template <class T>
+T& compact_list<T>::back()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot get last item from an empty list");
+
+    return m_pool[m_tail].item;
+}
+
+template <class T>
+void compact_list<T>::insert(const size_t index, const T& value)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    uint32_t next = index == m_size ? compact_list_npos : node_at(index);
+    link_before(allocate_node(value), next);
+}
+
+template <class T>
+void compact_list<T>::erase(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to erase");
+
+    remove_node(node_at(index));
+}
+
+template <class T>
+T& compact_list<T>::value_n_from_end(const size_t n)
+{
+    if (n >= m_size)
+        throw std::out_of_range("Out of range index to get value from end");
+
+    uint32_t current = m_tail;
+    for (size_t i = 0; i < n; ++i)
+        current = m_pool[current].prev;
+
+    return m_pool[current].item;
+}
+
+template <class T>
+void compact_list<T>::reverse()
+{
+    if (!m_size)
+        return;
+
+    uint32_t current;
+    for (current = m_head; current != compact_list_npos; current = m_pool[current].prev)
+    {
+        uint32_t tmp         = m_pool[current].prev;
+        m_pool[current].prev = m_pool[current].next;
+        m_pool[current].next = tmp;
+    }
+
+    current = m_head;
+    m_head  = m_tail;
+    m_tail  = current;
+}
+
+template <class T>
+void compact_list<T>::remove_value(const T& value)
+{
+    for (uint32_t current = m_head; current != compact_list_npos; current = m_pool[current].next)
+    {
+        if (m_comparator(value, m_pool[current].item))
+        {
+            remove_node(current);
+            break;
+        }
+    }
+}
+
+/* Walks from whichever end is closer to index */
+template <class T>
+uint32_t compact_list<T>::node_at(const size_t index)
+{
+    uint32_t current;
+    if (index < m_size / 2)
+    {
+        current = m_head;
+        for (size_t i = 0; i < index; ++i)
+            current = m_pool[current].next;
+    }
+    else
+    {
+        current = m_tail;
+        for (size_t i = m_size - 1; i > index; --i)
+            current = m_pool[current].prev;
+    }
+
+    return current;
+}
+
+template <class T>
+uint32_t compact_list<T>::allocate_node(const T& value)
+{
+    uint32_t index;
+    if (m_free != compact_list_npos)
+    {
+        index  = m_free;
+        m_free = m_pool[index].next;
+    }
+    else
+    {
+        if (m_used == m_capacity)
+            grow();
+        index = m_used++;
+    }
+
+    m_pool[index].item = value;
+    return index;
+}
+
+/* Links node index in front of next, or at the back when next is npos */
+template <class T>
+void compact_list<T>::link_before(const uint32_t index, const uint32_t next)
+{
+    uint32_t prev       = next == compact_list_npos ? m_tail : m_pool[next].prev;
+    m_pool[index].next = next;
+    m_pool[index].prev = prev;
+
+    if (prev != compact_list_npos)
+        m_pool[prev].next = index;
+    else
+        m_head = index;
+
+    if (next != compact_list_npos)
+        m_pool[next].prev = index;
+    else
+        m_tail = index;
+
+    m_size++;
+}
+
+template <class T>
+void compact_list<T>::remove_node(const uint32_t index)
+{
+    node_t& to_remove = m_pool[index];
+
+    if (to_remove.prev != compact_list_npos)
+        m_pool[to_remove.prev].next = to_remove.next;
+    else
+        m_head = to_remove.next;
+
+    if (to_remove.next != compact_list_npos)
+        m_pool[to_remove.next].prev = to_remove.prev;
+    else
+        m_tail = to_remove.prev;
+
+    to_remove.next = m_free;
+    m_free         = index;
+    m_size--;
+}
+
+template <class T>
+void compact_list<T>::grow()
+{
+    if (m_capacity == compact_list_npos - 1)
+        throw std::length_error("compact_list cannot index more nodes");
+
+    uint32_t new_capacity = m_capacity > (compact_list_npos - 1) / 2 ? compact_list_npos - 1 : m_capacity * 2;
+
+    node_t* temp_pool = new node_t[new_capacity];
+    for (uint32_t i = 0; i < m_used; ++i)
+        *(temp_pool + i) = *(m_pool + i);
+
+    delete[] m_pool;
+    m_pool     = temp_pool;
+    m_capacity = new_capacity;
+}
+
+} // namespace orla
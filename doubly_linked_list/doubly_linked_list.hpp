@@ -1,14 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <cstdint>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <utility>
+#include "bounds.hpp"
+#include "stats.hpp"
 
 namespace orla
 {
-template <class T>
-class doubly_linked_list
+template <class T, class Stats = null_stats, class Bounds = checked_bounds>
+class doubly_linked_list : private Stats
 {
+private:
+    struct node;
+
 public:
     typedef bool (*item_comparator)(const T& a, const T& b);
+    class iterator;
+    typedef node* node_handle;
 
     doubly_linked_list(item_comparator comparator);
     doubly_linked_list(const doubly_linked_list& list) = delete;
@@ -23,36 +37,187 @@ public:
     T      pop_back();
     T&     front();
     T&     back();
+    T&     front_unchecked() noexcept;
+    T&     back_unchecked() noexcept;
+    T      pop_front_unchecked();
+    T      pop_back_unchecked();
     void   insert(const size_t index, const T& value);
     void   erase(const size_t index);
     T&     value_n_from_end(const size_t n);
     void   reverse();
     void   remove_value(const T& value);
+    void   truncate(const size_t new_size);
+    void   value_at_many(const size_t* indices, const size_t count, T** values);
+    size_t erase_many(const size_t* indices, const size_t count);
+
+    access_error try_value_at(const size_t index, T** value) noexcept;
+    access_error try_pop_front(T* value);
+    access_error try_pop_back(T* value);
+
+    iterator begin();
+    iterator end();
+
+    using Stats::stats;
+    using Stats::reset_stats;
+
+    node_handle push_front_node(const T& value);
+    node_handle push_back_node(const T& value);
+    node_handle front_node();
+    node_handle back_node();
+    T&          value_of(node_handle handle);
+    void        move_to_front(node_handle handle);
+    void        move_to_back(node_handle handle);
+    void        erase_node(node_handle handle);
+
+    void          reserve(const size_t count);
+    void          relayout();
+    bool          relayout_step(const size_t max_nodes);
+    bool          is_relayout_pending();
+    double        average_stride();
+    static size_t node_stride();
 
 private:
     /* data */
+    struct slab;
+
     typedef struct node
     {
         T     item;
         node* next;
         node* prev;
+        slab* owner; /* null for nodes allocated on their own */
     } node_t;
 
+    /* Free slab nodes are raw storage threaded through their first bytes */
+    typedef struct free_node
+    {
+        free_node* next;
+    } free_node_t;
+
+    /*
+     * Contiguous block of nodes from reserve() or relayout. Relayout slabs are
+     * freed once none of their nodes is live, reserved ones stay until the list
+     * is destroyed. Slabs with room left are also linked on the open list.
+     */
+    typedef struct slab
+    {
+        slab*        next;
+        slab*        prev;
+        slab*        next_open;
+        slab*        prev_open;
+        node_t*      nodes;
+        size_t       capacity;
+        size_t       used;
+        size_t       live;
+        free_node_t* free;
+        bool         open;
+        bool         reserved;
+    } slab_t;
+
     size_t          m_size;
     node_t*         m_head;
     node_t*         m_tail;
     item_comparator m_comparator;
+    slab_t*         m_slabs;
+    slab_t*         m_open_slabs;
+    slab_t*         m_relayout_slab;
+    node_t*         m_relayout_cursor;
 
     /* functions */
-    void remove_next_node(node_t** node);
+    slab_t* new_slab(const size_t capacity, const bool reserved);
+    node_t* node_at(const size_t index);
+    void    remove_next_node(node_t** node);
+    void    check_indices(const size_t* indices, const size_t count);
+    void    unlink(node_t* node);
+    void    link_front(node_t* node);
+    void    link_back(node_t* node);
+    node_t* allocate_node(const T& value);
+    void    release_node(node_t* node);
+    void    update_open_slabs(slab_t* slab);
+    void    unlink_open_slab(slab_t* slab);
+    void    free_slab(slab_t* slab);
+    void    finish_relayout();
+};
+
+/* Decrementing end() yields the tail, so reverse iteration starts in O(1) */
+template <class T, class Stats, class Bounds>
+class doubly_linked_list<T, Stats, Bounds>::iterator
+{
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T                               value_type;
+    typedef ptrdiff_t                       difference_type;
+    typedef T*                              pointer;
+    typedef T&                              reference;
+
+    iterator()
+        : m_node{ nullptr }
+        , m_list{ nullptr }
+    {
+    }
+
+    T& operator*() const
+    {
+        return m_node->item;
+    }
+    T* operator->() const
+    {
+        return &m_node->item;
+    }
+    iterator& operator++()
+    {
+        m_node = m_node->next;
+        return *this;
+    }
+    iterator operator++(int)
+    {
+        iterator ret = *this;
+        m_node       = m_node->next;
+        return ret;
+    }
+    iterator& operator--()
+    {
+        m_node = m_node ? m_node->prev : m_list->m_tail;
+        return *this;
+    }
+    iterator operator--(int)
+    {
+        iterator ret = *this;
+        --*this;
+        return ret;
+    }
+    bool operator==(const iterator& other) const
+    {
+        return m_node == other.m_node;
+    }
+    bool operator!=(const iterator& other) const
+    {
+        return m_node != other.m_node;
+    }
+
+private:
+    friend class doubly_linked_list<T, Stats, Bounds>;
+
+    iterator(node_t* node, doubly_linked_list<T, Stats, Bounds>* list)
+        : m_node{ node }
+        , m_list{ list }
+    {
+    }
+
+    node_t*                       m_node;
+    doubly_linked_list<T, Stats, Bounds>* m_list;
 };
 
-template <class T>
-doubly_linked_list<T>::doubly_linked_list(item_comparator comparator)
+template <class T, class Stats, class Bounds>
+doubly_linked_list<T, Stats, Bounds>::doubly_linked_list(item_comparator comparator)
     : m_size{ 0 }
     , m_head{ nullptr }
     , m_tail{ nullptr }
     , m_comparator{ comparator }
+    , m_slabs{ nullptr }
+    , m_open_slabs{ nullptr }
+    , m_relayout_slab{ nullptr }
+    , m_relayout_cursor{ nullptr }
 {
     if (!m_comparator)
     {
@@ -60,67 +225,70 @@ doubly_linked_list<T>::doubly_linked_list(item_comparator comparator)
     }
 }
 
-template <class T>
-doubly_linked_list<T>::~doubly_linked_list()
+template <class T, class Stats, class Bounds>
+doubly_linked_list<T, Stats, Bounds>::~doubly_linked_list()
 {
+    finish_relayout();
+
     node_t* del;
     while (m_head)
     {
         del    = m_head;
         m_head = m_head->next;
-        delete del;
+        release_node(del);
     }
+
+    while (m_slabs)
+        free_slab(m_slabs);
 }
 
-template <class T>
-size_t doubly_linked_list<T>::size()
+template <class T, class Stats, class Bounds>
+size_t doubly_linked_list<T, Stats, Bounds>::size()
 {
     return m_size;
 }
 
-template <class T>
-bool doubly_linked_list<T>::is_empty()
+template <class T, class Stats, class Bounds>
+bool doubly_linked_list<T, Stats, Bounds>::is_empty()
 {
     return !m_size;
 }
 
-template <class T>
-T& doubly_linked_list<T>::value_at(const size_t index)
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::value_at(const size_t index)
 {
-    if (index >= m_size)
-        throw std::out_of_range("Out of range index");
-
-    node_t* tmp = m_head;
-    for (size_t i = 1; i <= index; i++)
-        tmp = tmp->next;
+    Bounds::check_index(index < m_size, "Out of range index");
 
-    return tmp->item;
+    return node_at(index)->item;
 }
 
-template <class T>
-void doubly_linked_list<T>::push_front(const T& value)
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::push_front(const T& value)
 {
     insert(0, value);
 }
 
-template <class T>
-T doubly_linked_list<T>::pop_front()
+template <class T, class Stats, class Bounds>
+T doubly_linked_list<T, Stats, Bounds>::pop_front()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot pop from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty list");
+
+    return pop_front_unchecked();
+}
 
+template <class T, class Stats, class Bounds>
+T doubly_linked_list<T, Stats, Bounds>::pop_front_unchecked()
+{
     T ret = m_head->item;
     remove_next_node(&m_head);
     return ret;
 }
 
-template <class T>
-void doubly_linked_list<T>::push_back(const T& value)
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::push_back(const T& value)
 {
-    node_t* n = new node_t;
-    n->next   = nullptr;
+    node_t* n = allocate_node(value);
     n->prev   = m_tail;
-    n->item   = value;
 
     if (m_tail)
         m_tail->next = n;
@@ -131,16 +299,21 @@ void doubly_linked_list<T>::push_back(const T& value)
     m_size++;
 }
 
-template <class T>
-T doubly_linked_list<T>::pop_back()
+template <class T, class Stats, class Bounds>
+T doubly_linked_list<T, Stats, Bounds>::pop_back()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot pop from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty list");
+
+    return pop_back_unchecked();
+}
 
+template <class T, class Stats, class Bounds>
+T doubly_linked_list<T, Stats, Bounds>::pop_back_unchecked()
+{
     T       ret    = m_tail->item;
     node_t* to_pop = m_tail;
     m_tail         = m_tail->prev;
-    delete to_pop;
+    release_node(to_pop);
 
     if (m_tail)
         m_tail->next = nullptr;
@@ -152,29 +325,38 @@ T doubly_linked_list<T>::pop_back()
     return ret;
 }
 
-template <class T>
-T& doubly_linked_list<T>::front()
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::front()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot get front item from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot get front item from an empty list");
 
     return m_head->item;
 }
 
-template <class T>
-T& doubly_linked_list<T>::back()
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::back()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot get last item from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot get last item from an empty list");
 
     return m_tail->item;
 }
 
-template <class T>
-void doubly_linked_list<T>::insert(const size_t index, const T& value)
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::front_unchecked() noexcept
 {
-    if (index > m_size)
-        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+    return m_head->item;
+}
+
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::back_unchecked() noexcept
+{
+    return m_tail->item;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::insert(const size_t index, const T& value)
+{
+    Bounds::check_index(index <= m_size, "Out of range index to insert item. Index should be <= size()");
 
     if (m_size && index == m_size)
     {
@@ -182,12 +364,12 @@ void doubly_linked_list<T>::insert(const size_t index, const T& value)
         return;
     }
 
-    node_t* new_node = new node_t;
-    new_node->item   = value;
+    node_t* new_node = allocate_node(value);
 
     node_t** current_node = &m_head;
     for (size_t i = 0; i < index; ++i)
         current_node = &(*current_node)->next;
+    this->count_hops(index);
 
     new_node->next = *current_node;
 
@@ -209,25 +391,27 @@ void doubly_linked_list<T>::insert(const size_t index, const T& value)
     m_size++;
 }
 
-template <class T>
-T& doubly_linked_list<T>::value_n_from_end(const size_t n)
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::value_n_from_end(const size_t n)
 {
-    if (n >= m_size)
-        throw std::out_of_range("Out of range index to get value from end");
+    Bounds::check_index(n < m_size, "Out of range index to get value from end");
 
     node_t* current_node = m_tail;
     for (size_t index = 0; index < n; ++index)
         current_node = current_node->prev;
+    this->count_hops(n);
 
     return current_node->item;
 }
 
-template <class T>
-void doubly_linked_list<T>::reverse()
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::reverse()
 {
     if (!m_size)
         return;
 
+    finish_relayout();
+
     node_t* current_node;
     for (current_node = m_head; current_node != nullptr; current_node = current_node->prev)
     {
@@ -239,46 +423,229 @@ void doubly_linked_list<T>::reverse()
     current_node = m_head;
     m_head       = m_tail;
     m_tail       = current_node;
+
+    this->count_hops(m_size);
 }
 
-template <class T>
-void doubly_linked_list<T>::remove_value(const T& value)
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::remove_value(const T& value)
 {
     if (!m_size)
         return;
 
     node_t** node;
+    size_t   visited = 0;
     for (node = &m_head; *node != nullptr; node = &(*node)->next)
     {
+        visited++;
         if (m_comparator(value, (*node)->item))
         {
             remove_next_node(node);
             break;
         }
     }
+
+    this->count_hops(visited);
+    this->count_comparisons(visited);
+}
+
+/* Drops the items from new_size on, releasing nodes from the tail */
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::truncate(const size_t new_size)
+{
+    Bounds::check_index(new_size <= m_size, "Out of range size to truncate to");
+
+    for (; m_size > new_size; m_size--)
+    {
+        node_t* to_pop = m_tail;
+        m_tail         = m_tail->prev;
+
+        if (m_tail)
+            m_tail->next = nullptr;
+        else
+            m_head = nullptr;
+
+        release_node(to_pop);
+    }
 }
 
-template <class T>
-void doubly_linked_list<T>::erase(const size_t index)
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::erase(const size_t index)
 {
-    if (index >= m_size)
-        throw std::out_of_range("Out of range index to erase");
+    Bounds::check_index(index < m_size, "Out of range index to erase");
 
     if (index == m_size - 1)
     {
-        pop_back();
+        pop_back_unchecked();
         return;
     }
 
     node_t** node = &m_head;
     for (size_t i = 0; i < index; ++i)
         node = &(*node)->next;
+    this->count_hops(index);
 
     remove_next_node(node);
 }
 
-template <class T>
-void doubly_linked_list<T>::remove_next_node(node_t** node)
+/*
+ * Stores in values[i] a pointer to the item at indices[i]. The requests are
+ * sorted, those in the first half of the list are answered in one pass from
+ * the head and the others in one pass from the tail.
+ */
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::value_at_many(const size_t* indices, const size_t count, T** values)
+{
+    check_indices(indices, count);
+
+    std::unique_ptr<std::pair<size_t, size_t>[]> order(new std::pair<size_t, size_t>[count]);
+    for (size_t i = 0; i < count; ++i)
+        order[i] = std::make_pair(indices[i], i);
+    std::sort(order.get(), order.get() + count);
+
+    size_t split = 0;
+    while (split < count && order[split].first < m_size / 2)
+        split++;
+
+    node_t* current_node = m_head;
+    size_t  position     = 0;
+    for (size_t i = 0; i < split; ++i)
+    {
+        for (; position < order[i].first; ++position)
+            current_node = current_node->next;
+
+        values[order[i].second] = &current_node->item;
+    }
+
+    size_t hops  = position;
+    current_node = m_tail;
+    position     = m_size - 1;
+    for (size_t i = count; i > split; --i)
+    {
+        for (; position > order[i - 1].first; --position)
+            current_node = current_node->prev;
+
+        values[order[i - 1].second] = &current_node->item;
+    }
+
+    this->count_hops(hops + m_size - 1 - position);
+}
+
+/*
+ * Erases the items at the given indices, all of them referring to positions
+ * before any erasure. Duplicates are erased once. The back half is erased
+ * walking from the tail, then the front half walking from the head. Returns
+ * the number of erased items.
+ */
+template <class T, class Stats, class Bounds>
+size_t doubly_linked_list<T, Stats, Bounds>::erase_many(const size_t* indices, const size_t count)
+{
+    check_indices(indices, count);
+
+    std::unique_ptr<size_t[]> sorted(new size_t[count]);
+    std::copy(indices, indices + count, sorted.get());
+    std::sort(sorted.get(), sorted.get() + count);
+    size_t unique = std::unique(sorted.get(), sorted.get() + count) - sorted.get();
+
+    size_t split = 0;
+    while (split < unique && sorted[split] < m_size / 2)
+        split++;
+
+    node_t* current_node = m_tail;
+    size_t  position     = m_size - 1;
+    size_t  hops         = 0;
+    for (size_t i = unique; i > split; --i)
+    {
+        for (; position > sorted[i - 1]; --position, ++hops)
+            current_node = current_node->prev;
+
+        node_t* prev = current_node->prev;
+        erase_node(current_node);
+        current_node = prev;
+        position--;
+    }
+
+    node_t** node = &m_head;
+    position      = 0;
+    for (size_t i = 0; i < split; ++i)
+    {
+        for (; position < sorted[i]; ++position)
+            node = &(*node)->next;
+
+        remove_next_node(node);
+        position++;
+    }
+
+    this->count_hops(hops + position - split);
+    return unique;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::check_indices(const size_t* indices, const size_t count)
+{
+    if (count && !indices)
+        throw std::invalid_argument("Null index array");
+
+    for (size_t i = 0; i < count; ++i)
+        Bounds::check_index(indices[i] < m_size, "Out of range index");
+}
+
+/* Points value at the item at index, or returns out_of_range and leaves it untouched */
+template <class T, class Stats, class Bounds>
+access_error doubly_linked_list<T, Stats, Bounds>::try_value_at(const size_t index, T** value) noexcept
+{
+    if (index >= m_size)
+        return access_error::out_of_range;
+
+    *value = &node_at(index)->item;
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+access_error doubly_linked_list<T, Stats, Bounds>::try_pop_front(T* value)
+{
+    if (!m_size)
+        return access_error::empty;
+
+    *value = pop_front_unchecked();
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+access_error doubly_linked_list<T, Stats, Bounds>::try_pop_back(T* value)
+{
+    if (!m_size)
+        return access_error::empty;
+
+    *value = pop_back_unchecked();
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::iterator doubly_linked_list<T, Stats, Bounds>::begin()
+{
+    return iterator(m_head, this);
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::iterator doubly_linked_list<T, Stats, Bounds>::end()
+{
+    return iterator(nullptr, this);
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_t* doubly_linked_list<T, Stats, Bounds>::node_at(const size_t index)
+{
+    node_t* tmp = m_head;
+    for (size_t i = 1; i <= index; i++)
+        tmp = tmp->next;
+
+    this->count_hops(index);
+    return tmp;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::remove_next_node(node_t** node)
 {
     node_t* to_destroy = *node;
 
@@ -288,7 +655,377 @@ void doubly_linked_list<T>::remove_next_node(node_t** node)
         m_tail = to_destroy->prev;
 
     *node = to_destroy->next;
-    delete to_destroy;
+    release_node(to_destroy);
+    m_size--;
+}
+
+/*
+ * Handles give O(1) access to a node for as long as it is in the list. They
+ * are invalidated by erasing the node and by relayout(), which moves nodes.
+ */
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_handle doubly_linked_list<T, Stats, Bounds>::push_front_node(
+    const T& value)
+{
+    node_t* n = allocate_node(value);
+    link_front(n);
+    return n;
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_handle doubly_linked_list<T, Stats, Bounds>::push_back_node(
+    const T& value)
+{
+    push_back(value);
+    return m_tail;
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_handle doubly_linked_list<T, Stats, Bounds>::front_node()
+{
+    return m_head;
+}
+
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_handle doubly_linked_list<T, Stats, Bounds>::back_node()
+{
+    return m_tail;
+}
+
+template <class T, class Stats, class Bounds>
+T& doubly_linked_list<T, Stats, Bounds>::value_of(node_handle handle)
+{
+    if (!handle)
+        throw std::invalid_argument("Null node handle");
+
+    return handle->item;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::move_to_front(node_handle handle)
+{
+    if (!handle)
+        throw std::invalid_argument("Null node handle");
+
+    if (handle == m_head)
+        return;
+
+    unlink(handle);
+    link_front(handle);
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::move_to_back(node_handle handle)
+{
+    if (!handle)
+        throw std::invalid_argument("Null node handle");
+
+    if (handle == m_tail)
+        return;
+
+    unlink(handle);
+    link_back(handle);
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::erase_node(node_handle handle)
+{
+    if (!handle)
+        throw std::invalid_argument("Null node handle");
+
+    unlink(handle);
+    release_node(handle);
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::unlink(node_t* node)
+{
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        m_head = node->next;
+
+    if (node->next)
+        node->next->prev = node->prev;
+    else
+        m_tail = node->prev;
+
     m_size--;
 }
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::link_front(node_t* node)
+{
+    node->prev = nullptr;
+    node->next = m_head;
+
+    if (m_head)
+        m_head->prev = node;
+    else
+        m_tail = node;
+
+    m_head = node;
+    m_size++;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::link_back(node_t* node)
+{
+    node->next = nullptr;
+    node->prev = m_tail;
+
+    if (m_tail)
+        m_tail->next = node;
+    else
+        m_head = node;
+
+    m_tail = node;
+    m_size++;
+}
+
+/*
+ * Preallocates count nodes in one contiguous slab that the following pushes
+ * and inserts take from, so a list built in one go starts out laid out in
+ * order. The slab is kept, even once empty, until the list is destroyed.
+ * Ignored while a relayout pass is pending.
+ */
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::reserve(const size_t count)
+{
+    if (count && !m_relayout_slab)
+        new_slab(count, true);
+}
+
+/* Moves every node, in list order, into one contiguous allocation */
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::relayout()
+{
+    finish_relayout();
+    relayout_step(SIZE_MAX);
+}
+
+/*
+ * Moves at most max_nodes further nodes into the slab of the current relayout
+ * pass, starting a pass if none is pending. Returns true once the pass is
+ * complete. Nodes added while a pass is pending are picked up if they sit
+ * past the cursor; reverse() abandons the pass.
+ */
+template <class T, class Stats, class Bounds>
+bool doubly_linked_list<T, Stats, Bounds>::relayout_step(const size_t max_nodes)
+{
+    if (!m_relayout_slab)
+    {
+        if (m_size < 2)
+            return true;
+
+        m_relayout_slab   = new_slab(m_size, false);
+        m_relayout_cursor = m_head;
+    }
+
+    slab_t* slab  = m_relayout_slab;
+    size_t  moved = 0;
+    for (; m_relayout_cursor && moved < max_nodes && slab->used < slab->capacity; ++moved)
+    {
+        node_t* old   = m_relayout_cursor;
+        node_t* fresh = new (slab->nodes + slab->used) node_t{ std::move(old->item), old->next, old->prev, slab };
+        slab->used++;
+        slab->live++;
+
+        if (fresh->prev)
+            fresh->prev->next = fresh;
+        else
+            m_head = fresh;
+
+        if (fresh->next)
+            fresh->next->prev = fresh;
+        else
+            m_tail = fresh;
+
+        m_relayout_cursor = old->next;
+        release_node(old);
+    }
+    this->count_moves(moved);
+    update_open_slabs(slab);
+
+    if (m_relayout_cursor && slab->used < slab->capacity)
+        return false;
+
+    finish_relayout();
+    return true;
+}
+
+template <class T, class Stats, class Bounds>
+bool doubly_linked_list<T, Stats, Bounds>::is_relayout_pending()
+{
+    return m_relayout_slab != nullptr;
+}
+
+/* Mean distance in bytes between consecutive nodes, node_stride() when contiguous */
+template <class T, class Stats, class Bounds>
+double doubly_linked_list<T, Stats, Bounds>::average_stride()
+{
+    if (m_size < 2)
+        return node_stride();
+
+    double total = 0;
+    for (node_t* current_node = m_head; current_node->next; current_node = current_node->next)
+    {
+        uintptr_t from = reinterpret_cast<uintptr_t>(current_node);
+        uintptr_t to   = reinterpret_cast<uintptr_t>(current_node->next);
+        total += to > from ? to - from : from - to;
+    }
+
+    return total / (m_size - 1);
+}
+
+template <class T, class Stats, class Bounds>
+size_t doubly_linked_list<T, Stats, Bounds>::node_stride()
+{
+    return sizeof(node_t);
+}
+
+/* Links an empty slab in front of the others, so its nodes are handed out first */
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::slab_t* doubly_linked_list<T, Stats, Bounds>::new_slab(
+    const size_t capacity, const bool reserved)
+{
+    slab_t* slab   = new slab_t;
+    slab->nodes    = static_cast<node_t*>(::operator new(capacity * sizeof(node_t)));
+    slab->capacity = capacity;
+    slab->used     = 0;
+    slab->live     = 0;
+    slab->free     = nullptr;
+    slab->open     = false;
+    slab->reserved = reserved;
+    slab->prev     = nullptr;
+    slab->next     = m_slabs;
+
+    if (m_slabs)
+        m_slabs->prev = slab;
+    m_slabs = slab;
+
+    update_open_slabs(slab);
+    this->count_allocation(capacity * sizeof(node_t));
+    return slab;
+}
+
+/*
+ * Copies value into a node from the first open slab, reusing its free nodes
+ * before untouched ones, except while a relayout pass drains old slabs
+ */
+template <class T, class Stats, class Bounds>
+typename doubly_linked_list<T, Stats, Bounds>::node_t* doubly_linked_list<T, Stats, Bounds>::allocate_node(
+    const T& value)
+{
+    if (!m_relayout_slab && m_open_slabs)
+    {
+        slab_t*      slab      = m_open_slabs;
+        free_node_t* free      = slab->free;
+        free_node_t* next_free = free ? free->next : nullptr;
+        void*        storage   = free ? static_cast<void*>(free) : static_cast<void*>(slab->nodes + slab->used);
+
+        node_t* n = new (storage) node_t{ value, nullptr, nullptr, slab };
+        if (free)
+            slab->free = next_free;
+        else
+            slab->used++;
+
+        slab->live++;
+        update_open_slabs(slab);
+        return n;
+    }
+
+    this->count_allocation(sizeof(node_t));
+    return new node_t{ value, nullptr, nullptr, nullptr };
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::release_node(node_t* node)
+{
+    if (node == m_relayout_cursor)
+        m_relayout_cursor = node->next;
+
+    slab_t* slab = node->owner;
+    if (!slab)
+    {
+        delete node;
+        return;
+    }
+
+    node->~node_t();
+    slab->free = new (static_cast<void*>(node)) free_node_t{ slab->free };
+    slab->live--;
+    update_open_slabs(slab);
+
+    if (!slab->live && !slab->reserved && slab != m_relayout_slab)
+        free_slab(slab);
+}
+
+/* Links slab at the front of the open list once it has room, unlinks it when full */
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::update_open_slabs(slab_t* slab)
+{
+    bool has_room = slab->free || slab->used < slab->capacity;
+    if (has_room == slab->open)
+        return;
+
+    if (!has_room)
+    {
+        unlink_open_slab(slab);
+        return;
+    }
+
+    slab->open      = true;
+    slab->prev_open = nullptr;
+    slab->next_open = m_open_slabs;
+
+    if (m_open_slabs)
+        m_open_slabs->prev_open = slab;
+    m_open_slabs = slab;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::unlink_open_slab(slab_t* slab)
+{
+    if (!slab->open)
+        return;
+
+    if (slab->prev_open)
+        slab->prev_open->next_open = slab->next_open;
+    else
+        m_open_slabs = slab->next_open;
+
+    if (slab->next_open)
+        slab->next_open->prev_open = slab->prev_open;
+
+    slab->open = false;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::free_slab(slab_t* slab)
+{
+    unlink_open_slab(slab);
+
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        m_slabs = slab->next;
+
+    if (slab->next)
+        slab->next->prev = slab->prev;
+
+    ::operator delete(slab->nodes);
+    delete slab;
+}
+
+template <class T, class Stats, class Bounds>
+void doubly_linked_list<T, Stats, Bounds>::finish_relayout()
+{
+    slab_t* slab      = m_relayout_slab;
+    m_relayout_slab   = nullptr;
+    m_relayout_cursor = nullptr;
+
+    if (slab && !slab->live)
+        free_slab(slab);
+}
 } // namespace orla
\ No newline at end of file
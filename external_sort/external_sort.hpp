@@ -0,0 +1,456 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include "mmap_vector.hpp"
+#include "priority_queue.hpp"
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const size_t default_external_run_items   = 1 << 22;
+static const size_t default_external_block_bytes = 1 << 20;
+static const size_t default_external_max_fan_in  = 64;
+
+struct external_sort_options
+{
+    size_t      run_items   = default_external_run_items;   /* items sorted in memory per run */
+    size_t      block_bytes = default_external_block_bytes; /* bytes read from a run per syscall */
+    size_t      max_fan_in  = default_external_max_fan_in;  /* runs open and merged at once */
+    const char* temp_dir    = nullptr;                      /* $TMPDIR, else /tmp, when null */
+};
+
+/**
+ * external_sorter - sorts more items than fit in memory through temporary files
+ *
+ * push() buffers items in an orla::vector. Every run_items items the buffer
+ * is sorted and spilled with one sequential write to a temporary file that
+ * is unlinked as soon as it is created, so its space is reclaimed however
+ * the process ends. finish() spills the last run and frees the buffer, then
+ * next() streams the items in order through a k-way merge: a priority_queue
+ * holds the head of every run, and each run refills its own block_bytes
+ * buffer with one pread. The merge needs block_bytes per run of memory.
+ *
+ * At most max_fan_in runs are open and merged at once. With more runs,
+ * finish() first merges groups of max_fan_in runs into new spilled runs,
+ * pass after pass, until max_fan_in or fewer remain. That bounds both the
+ * open files and the merge buffers at max_fan_in + 1 blocks for any input.
+ *
+ * When all items fit in a single run nothing is written and next() reads
+ * the sorted buffer. write_to() drains the sorter into a file backed
+ * mmap_vector.
+ *
+ *     orla::external_sorter<uint64_t> sorter;
+ *     sorter.push(keys.begin(), keys.end());
+ *     for (uint64_t key; sorter.next(key);)
+ *         ...
+ */
+template <class T, class Compare = std::less<T>>
+class external_sorter
+{
+    static_assert(std::is_trivially_copyable<T>::value, "external_sorter items must be trivially copyable");
+
+public:
+    external_sorter(const external_sort_options& options = external_sort_options(), const Compare& compare = Compare());
+    external_sorter(const external_sorter& sorter) = delete;
+    ~external_sorter();
+
+    size_t size();
+    size_t run_count();
+    bool   is_finished();
+
+    void push(const T& item);
+    template <class It>
+    void push(It first, It last);
+    void finish();
+    bool next(T& item);
+    void write_to(mmap_vector<T>& out);
+
+private:
+    /* data */
+    typedef vector<T, default_allocator<T>, null_stats, unchecked_bounds> buffer_t;
+
+    typedef struct run
+    {
+        int    fd;
+        size_t count;
+        size_t loaded; /* items read from the file so far */
+        T*     block;
+        size_t block_size;
+        size_t position;
+    } run_t;
+
+    typedef struct head
+    {
+        T      item;
+        size_t run;
+    } head_t;
+
+    typedef vector<run_t, default_allocator<run_t>, null_stats, unchecked_bounds> runs_t;
+
+    struct head_compare
+    {
+        Compare compare;
+
+        bool operator()(const head_t& a, const head_t& b) const
+        {
+            return compare(a.item, b.item);
+        }
+    };
+
+    external_sort_options                m_options;
+    Compare                              m_compare;
+    std::unique_ptr<buffer_t>            m_buffer;
+    runs_t                               m_runs;
+    priority_queue<head_t, head_compare> m_heads;
+    size_t                               m_size;
+    size_t                               m_emitted;
+    bool                                 m_finished;
+
+    /* functions */
+    void        spill();
+    void        merge_pass();
+    void        start_merge(const size_t first, const size_t last);
+    bool        pop_head(T& item);
+    void        append_to_run(run_t& run, const T* items, const size_t count);
+    void        close_run(run_t& run);
+    int         create_run_file();
+    void        load_block(run_t& run);
+    size_t      block_items();
+    static bool item_comparator(const T& a, const T& b);
+    static bool run_comparator(const run_t& a, const run_t& b);
+    static void throw_errno(const char* what);
+};
+
+template <class T, class Compare>
+external_sorter<T, Compare>::external_sorter(const external_sort_options& options, const Compare& compare)
+    : m_options(options)
+    , m_compare(compare)
+    , m_buffer{ new buffer_t(item_comparator) }
+    , m_runs{ run_comparator }
+    , m_heads(head_compare{ compare })
+    , m_size{ 0 }
+    , m_emitted{ 0 }
+    , m_finished{ false }
+{
+    if (!m_options.run_items)
+        throw std::invalid_argument("Runs need at least one item");
+    if (m_options.max_fan_in < 2)
+        throw std::invalid_argument("Merges need a fan-in of at least two runs");
+}
+
+template <class T, class Compare>
+external_sorter<T, Compare>::~external_sorter()
+{
+    for (size_t i = 0; i < m_runs.size(); ++i)
+        close_run(m_runs[i]);
+}
+
+template <class T, class Compare>
+size_t external_sorter<T, Compare>::size()
+{
+    return m_size;
+}
+
+template <class T, class Compare>
+size_t external_sorter<T, Compare>::run_count()
+{
+    return m_runs.size();
+}
+
+template <class T, class Compare>
+bool external_sorter<T, Compare>::is_finished()
+{
+    return m_finished;
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::push(const T& item)
+{
+    if (m_finished)
+        throw std::logic_error("Cannot push to a finished external_sorter");
+
+    m_buffer->push(item);
+    m_size++;
+
+    if (m_buffer->size() >= m_options.run_items)
+        spill();
+}
+
+template <class T, class Compare>
+template <class It>
+void external_sorter<T, Compare>::push(It first, It last)
+{
+    for (; first != last; ++first)
+        push(*first);
+}
+
+/* Ends the input; called by next() when needed */
+template <class T, class Compare>
+void external_sorter<T, Compare>::finish()
+{
+    if (m_finished)
+        return;
+
+    m_finished = true;
+    if (m_runs.is_empty())
+    {
+        std::sort(m_buffer->begin(), m_buffer->end(), m_compare);
+        return;
+    }
+
+    if (!m_buffer->is_empty())
+        spill();
+    m_buffer.reset();
+
+    while (m_runs.size() > m_options.max_fan_in)
+        merge_pass();
+
+    start_merge(0, m_runs.size());
+}
+
+template <class T, class Compare>
+bool external_sorter<T, Compare>::next(T& item)
+{
+    finish();
+
+    if (m_runs.is_empty())
+    {
+        if (m_emitted == m_size)
+            return false;
+
+        item = (*m_buffer)[m_emitted++];
+        return true;
+    }
+
+    if (!pop_head(item))
+        return false;
+
+    m_emitted++;
+    return true;
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::write_to(mmap_vector<T>& out)
+{
+    finish();
+
+    out.reserve(out.size() + m_size - m_emitted);
+
+    T item;
+    while (next(item))
+        out.push(item);
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::spill()
+{
+    std::sort(m_buffer->begin(), m_buffer->end(), m_compare);
+
+    run_t run = { create_run_file(), 0, 0, nullptr, 0, 0 };
+    append_to_run(run, m_buffer->data(), m_buffer->size());
+
+    m_runs.push(run);
+    m_buffer->clear();
+}
+
+/*
+ * Merges every group of max_fan_in runs into one new run. Merged runs are
+ * closed in place and compacted away at the end, so a failure midway
+ * leaves every open file in m_runs for the destructor.
+ */
+template <class T, class Compare>
+void external_sorter<T, Compare>::merge_pass()
+{
+    std::unique_ptr<T[]> out(new T[block_items()]);
+
+    size_t count = m_runs.size();
+    for (size_t first = 0; first + 1 < count; first += m_options.max_fan_in)
+    {
+        size_t last = std::min(first + m_options.max_fan_in, count);
+        run_t  run  = { create_run_file(), 0, 0, nullptr, 0, 0 };
+        m_runs.push(run);
+
+        start_merge(first, last);
+        size_t buffered = 0;
+        for (T item; pop_head(item);)
+        {
+            out[buffered++] = item;
+            if (buffered == block_items())
+            {
+                append_to_run(m_runs[m_runs.size() - 1], out.get(), buffered);
+                buffered = 0;
+            }
+        }
+        append_to_run(m_runs[m_runs.size() - 1], out.get(), buffered);
+
+        for (size_t i = first; i < last; ++i)
+            close_run(m_runs[i]);
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < m_runs.size(); ++i)
+    {
+        if (m_runs[i].fd >= 0)
+            m_runs[kept++] = m_runs[i];
+    }
+    m_runs.truncate(kept);
+}
+
+/* Loads the first block of the runs in [first, last) and queues their heads */
+template <class T, class Compare>
+void external_sorter<T, Compare>::start_merge(const size_t first, const size_t last)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        run_t& run = m_runs[i];
+        run.block  = new T[block_items()];
+        load_block(run);
+        m_heads.push(head_t{ run.block[run.position++], i });
+    }
+}
+
+template <class T, class Compare>
+bool external_sorter<T, Compare>::pop_head(T& item)
+{
+    if (m_heads.is_empty())
+        return false;
+
+    /* The run of the smallest head replaces it in place, one sift instead of a pop and a push */
+    head_t top = m_heads.top();
+    item       = top.item;
+
+    run_t& run = m_runs[top.run];
+    if (run.position == run.block_size && run.loaded < run.count)
+        load_block(run);
+
+    if (run.position < run.block_size)
+        m_heads.update(m_heads.top_handle(), head_t{ run.block[run.position++], top.run });
+    else
+        m_heads.pop();
+
+    return true;
+}
+
+/* Appends items to the run file with sequential writes, closing it on failure */
+template <class T, class Compare>
+void external_sorter<T, Compare>::append_to_run(run_t& run, const T* items, const size_t count)
+{
+    const char* data  = reinterpret_cast<const char*>(items);
+    size_t      bytes = count * sizeof(T);
+    while (bytes)
+    {
+        ssize_t written = write(run.fd, data, bytes);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            int error = errno;
+            close_run(run);
+            errno = error;
+            throw_errno("Cannot write run file");
+        }
+
+        data += written;
+        bytes -= written;
+    }
+
+    run.count += count;
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::close_run(run_t& run)
+{
+    if (run.fd >= 0)
+        close(run.fd);
+    delete[] run.block;
+
+    run.fd    = -1;
+    run.block = nullptr;
+}
+
+template <class T, class Compare>
+int external_sorter<T, Compare>::create_run_file()
+{
+    const char* dir = m_options.temp_dir;
+    if (!dir)
+        dir = getenv("TMPDIR");
+    if (!dir)
+        dir = "/tmp";
+
+    std::string path = std::string(dir) + "/orla_sort_XXXXXX";
+    int         fd   = mkstemp(&path[0]);
+    if (fd < 0)
+        throw_errno("Cannot create run file");
+
+    unlink(path.c_str());
+    return fd;
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::load_block(run_t& run)
+{
+    size_t items = std::min(block_items(), run.count - run.loaded);
+    char*  data  = reinterpret_cast<char*>(run.block);
+    size_t bytes = items * sizeof(T);
+    off_t  at    = run.loaded * sizeof(T);
+    while (bytes)
+    {
+        ssize_t done = pread(run.fd, data, bytes, at);
+        if (done < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw_errno("Cannot read run file");
+        }
+        if (!done)
+            throw std::runtime_error("Truncated run file");
+
+        data += done;
+        bytes -= done;
+        at += done;
+    }
+
+    run.block_size = items;
+    run.position   = 0;
+
+    run.loaded += items;
+}
+
+template <class T, class Compare>
+size_t external_sorter<T, Compare>::block_items()
+{
+    size_t items = m_options.block_bytes / sizeof(T);
+    return items ? items : 1;
+}
+
+template <class T, class Compare>
+bool external_sorter<T, Compare>::item_comparator(const T& a, const T& b)
+{
+    return !memcmp(&a, &b, sizeof(T));
+}
+
+template <class T, class Compare>
+bool external_sorter<T, Compare>::run_comparator(const run_t& a, const run_t& b)
+{
+    return a.fd == b.fd;
+}
+
+template <class T, class Compare>
+void external_sorter<T, Compare>::throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace orla
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "parallel.hpp"
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const size_t huge_page_size  = 2 << 20;
+static const size_t small_page_size = 4 << 10;
+static const size_t max_numa_nodes  = 64;
+static const int    mpol_interleave = 3; /* MPOL_INTERLEAVE from linux/mempolicy.h */
+
+enum class numa_policy
+{
+    none,       /* pages land on the node of the thread touching them first */
+    interleave, /* pages are spread round robin over the online nodes */
+    first_touch /* pool threads fault the pages in right after mapping */
+};
+
+/**
+ * huge_page_allocator - vector storage policy for buffers of many megabytes
+ *
+ * Buffers of at least Threshold bytes are anonymous mappings rounded up and
+ * aligned to huge_page_size and advised with MADV_HUGEPAGE, so random at()
+ * costs one TLB entry per 2 MiB instead of per 4 KiB. When transparent huge
+ * pages are set to never, or the advice is refused, the buffer is taken
+ * with MAP_HUGETLB from the reserved hugetlbfs pool instead and kept on
+ * small pages if that is empty too. Growing or shrinking a mapped buffer
+ * uses mremap, which moves page table entries instead of copying items; a
+ * growing buffer is moved into a fresh huge page aligned reservation so it
+ * keeps its alignment. Smaller buffers use new[] and delete[].
+ *
+ * Policy optionally places the pages over NUMA nodes; it is a no-op on
+ * single node machines and kernels without mbind. Items must be trivial
+ * since mapped memory is neither constructed nor destroyed.
+ *
+ *     orla::vector<float, orla::huge_page_allocator<float, orla::numa_policy::interleave>> v(cmp);
+ */
+template <class T, numa_policy Policy = numa_policy::none, size_t Threshold = huge_page_size>
+struct huge_page_allocator
+{
+    static_assert(std::is_trivial<T>::value, "huge_page_allocator items must be trivial");
+
+    static T*   allocate(const size_t capacity);
+    static void deallocate(T* array, const size_t capacity);
+    static T*   reallocate(T* array, const size_t capacity, const size_t new_capacity, const size_t size);
+    static bool is_mapped(const size_t capacity);
+
+private:
+    static size_t mapped_bytes(const size_t capacity);
+    static void*  map(const size_t bytes);
+    static void*  map_aligned(const size_t bytes, const int protection);
+    static void*  map_hugetlb(const size_t bytes);
+    static void   place(void* mapping, const size_t from, const size_t bytes);
+};
+
+namespace detail
+{
+
+/* Parses a node list such as "0-3,6" into a bitmask, zero when unreadable */
+inline uint64_t read_online_numa_nodes()
+{
+    FILE* file = fopen("/sys/devices/system/node/online", "r");
+    if (!file)
+        return 0;
+
+    char line[256];
+    bool read = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+    if (!read)
+        return 0;
+
+    uint64_t nodes  = 0;
+    char*    cursor = line;
+    while (*cursor >= '0' && *cursor <= '9')
+    {
+        unsigned long first = strtoul(cursor, &cursor, 10);
+        unsigned long last  = first;
+        if (*cursor == '-')
+            last = strtoul(cursor + 1, &cursor, 10);
+
+        for (unsigned long node = first; node <= last && node < max_numa_nodes; ++node)
+            nodes |= 1ULL << node;
+
+        if (*cursor == ',')
+            cursor++;
+    }
+
+    return nodes;
+}
+
+inline uint64_t online_numa_nodes()
+{
+    static const uint64_t nodes = read_online_numa_nodes();
+    return nodes;
+}
+
+/* False when the selected mode is "[never]" or the kernel has no transparent huge pages */
+inline bool read_transparent_huge_pages()
+{
+    FILE* file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!file)
+        return false;
+
+    char line[256];
+    bool read = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+
+    return read && !strstr(line, "[never]");
+}
+
+inline bool transparent_huge_pages()
+{
+    static const bool enabled = read_transparent_huge_pages();
+    return enabled;
+}
+
+inline void interleave_pages(void* address, const size_t bytes)
+{
+#ifdef SYS_mbind
+    uint64_t nodes = online_numa_nodes();
+    if (__builtin_popcountll(nodes) < 2)
+        return;
+
+    /* Best effort, the mapping stays usable under the default policy */
+    syscall(SYS_mbind, address, bytes, mpol_interleave, &nodes, max_numa_nodes + 1, 0);
+#else
+    (void)address;
+    (void)bytes;
+#endif
+}
+
+/* Faults the range in from the pool threads, one huge page per task */
+inline void touch_pages_in_parallel(char* address, const size_t bytes)
+{
+    size_t tasks = (bytes + huge_page_size - 1) / huge_page_size;
+    thread_pool::shared().run(tasks, [address, bytes](size_t task) {
+        size_t first = task * huge_page_size;
+        size_t last  = first + huge_page_size < bytes ? first + huge_page_size : bytes;
+        for (size_t offset = first; offset < last; offset += small_page_size)
+            *static_cast<volatile char*>(address + offset) = 0;
+    });
+}
+
+} // namespace detail
+
+template <class T, numa_policy Policy, size_t Threshold>
+T* huge_page_allocator<T, Policy, Threshold>::allocate(const size_t capacity)
+{
+    if (!is_mapped(capacity))
+        return new T[capacity];
+
+    size_t bytes   = mapped_bytes(capacity);
+    void*  mapping = map(bytes);
+    place(mapping, 0, bytes);
+    return static_cast<T*>(mapping);
+}
+
+template <class T, numa_policy Policy, size_t Threshold>
+void huge_page_allocator<T, Policy, Threshold>::deallocate(T* array, const size_t capacity)
+{
+    if (!is_mapped(capacity))
+    {
+        delete[] array;
+        return;
+    }
+
+    munmap(array, mapped_bytes(capacity));
+}
+
+/* Mapped to mapped resizes go through mremap, crossing Threshold copies */
+template <class T, numa_policy Policy, size_t Threshold>
+T* huge_page_allocator<T, Policy, Threshold>::reallocate(T*           array,
+                                                         const size_t capacity,
+                                                         const size_t new_capacity,
+                                                         const size_t size)
+{
+    if (is_mapped(capacity) && is_mapped(new_capacity))
+    {
+        size_t bytes     = mapped_bytes(capacity);
+        size_t new_bytes = mapped_bytes(new_capacity);
+        if (bytes == new_bytes)
+            return array;
+
+        /* Shrinking stays in place; growing moves into an aligned reservation it replaces */
+        void* mapping = MAP_FAILED;
+        if (new_bytes < bytes)
+        {
+            mapping = mremap(array, bytes, new_bytes, 0);
+        }
+        else
+        {
+            void* target = map_aligned(new_bytes, PROT_NONE);
+            mapping      = mremap(array, bytes, new_bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (mapping == MAP_FAILED)
+                munmap(target, new_bytes);
+        }
+
+        if (mapping != MAP_FAILED)
+        {
+            if (new_bytes > bytes)
+                place(mapping, bytes, new_bytes);
+            return static_cast<T*>(mapping);
+        }
+        /* hugetlbfs mappings cannot be remapped on older kernels */
+    }
+
+    T* temp_array = allocate(new_capacity);
+    memcpy(static_cast<void*>(temp_array), array, size * sizeof(T));
+    deallocate(array, capacity);
+    return temp_array;
+}
+
+template <class T, numa_policy Policy, size_t Threshold>
+bool huge_page_allocator<T, Policy, Threshold>::is_mapped(const size_t capacity)
+{
+    return capacity * sizeof(T) >= Threshold;
+}
+
+template <class T, numa_policy Policy, size_t Threshold>
+size_t huge_page_allocator<T, Policy, Threshold>::mapped_bytes(const size_t capacity)
+{
+    return (capacity * sizeof(T) + huge_page_size - 1) / huge_page_size * huge_page_size;
+}
+
+template <class T, numa_policy Policy, size_t Threshold>
+void* huge_page_allocator<T, Policy, Threshold>::map(const size_t bytes)
+{
+    /* Without transparent huge pages the advice below is accepted and ignored */
+    if (!detail::transparent_huge_pages())
+    {
+        void* hugetlb = map_hugetlb(bytes);
+        if (hugetlb)
+            return hugetlb;
+    }
+
+    void* mapping = map_aligned(bytes, PROT_READ | PROT_WRITE);
+
+#ifdef MADV_HUGEPAGE
+    if (!madvise(mapping, bytes, MADV_HUGEPAGE))
+        return mapping;
+#endif
+
+    void* hugetlb = detail::transparent_huge_pages() ? map_hugetlb(bytes) : nullptr;
+    if (hugetlb)
+    {
+        munmap(mapping, bytes);
+        return hugetlb;
+    }
+
+    return mapping;
+}
+
+/* Over-maps by one huge page and trims, so the bytes start on a huge page boundary */
+template <class T, numa_policy Policy, size_t Threshold>
+void* huge_page_allocator<T, Policy, Threshold>::map_aligned(const size_t bytes, const int protection)
+{
+    size_t padded  = bytes + huge_page_size;
+    void*  mapping = mmap(nullptr, padded, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        throw std::bad_alloc();
+
+    uintptr_t start   = reinterpret_cast<uintptr_t>(mapping);
+    uintptr_t aligned = (start + huge_page_size - 1) / huge_page_size * huge_page_size;
+    if (aligned != start)
+        munmap(mapping, aligned - start);
+    if (aligned + bytes != start + padded)
+        munmap(reinterpret_cast<void*>(aligned + bytes), start + padded - aligned - bytes);
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+/* A mapping from the hugetlbfs pool, null when the pool is empty or unsupported */
+template <class T, numa_policy Policy, size_t Threshold>
+void* huge_page_allocator<T, Policy, Threshold>::map_hugetlb(const size_t bytes)
+{
+#ifdef MAP_HUGETLB
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapping != MAP_FAILED)
+        return mapping;
+#else
+    (void)bytes;
+#endif
+
+    return nullptr;
+}
+
+/* Applies the NUMA policy to the fresh pages in [from, bytes) of mapping */
+template <class T, numa_policy Policy, size_t Threshold>
+void huge_page_allocator<T, Policy, Threshold>::place(void* mapping, const size_t from, const size_t bytes)
+{
+    char* fresh = static_cast<char*>(mapping) + from;
+
+#ifdef MADV_HUGEPAGE
+    if (from)
+        madvise(fresh, bytes - from, MADV_HUGEPAGE);
+#endif
+
+    if (Policy == numa_policy::interleave)
+        detail::interleave_pages(fresh, bytes - from);
+    else if (Policy == numa_policy::first_touch)
+        detail::touch_pages_in_parallel(fresh, bytes - from);
+}
+
+} // namespace orla
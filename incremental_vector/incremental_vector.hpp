@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include "vector.hpp"
+
+namespace orla
+{
+
+/* Items moved from the old buffer per operation; two keep up with doubling */
+static const size_t incremental_vector_migration_step = 2;
+
+/**
+ * incremental_vector - vector whose growth never copies the whole array at once
+ *
+ * When push() finds the buffer full it allocates one of twice the capacity
+ * and leaves the items where they are. Every later push() or pop() then
+ * moves incremental_vector_migration_step items into the new buffer, so the
+ * old one is drained long before the new one fills up and push() is
+ * worst-case O(1) apart from the allocation itself. While migrating, at()
+ * looks up each index in whichever buffer currently holds it.
+ *
+ * Operations that are O(n) anyway (insert, erase_at, remove, data) finish
+ * the migration first. Storage is raw memory, so growing does not construct
+ * capacity() items; the capacity never shrinks.
+ */
+template <class T>
+class incremental_vector
+{
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    incremental_vector(item_comparator comparator);
+    incremental_vector(const incremental_vector& vector) = delete;
+    ~incremental_vector();
+
+    size_t size();
+    size_t capacity();
+    bool   is_empty();
+    bool   is_migrating();
+
+    T&   at(const size_t index);
+    T*   data();
+    void push(const T& item);
+    void insert(const size_t index, const T& item);
+    void prepend(const T& item);
+    T    pop();
+    void erase_at(const size_t index);
+    void remove(const T& item);
+    int  find(const T& item);
+    void finish_migration();
+
+private:
+    /* data */
+    size_t          m_capacity;
+    size_t          m_size;
+    T*              m_array;
+    T*              m_old;
+    size_t          m_old_size;
+    size_t          m_migrated;
+    item_comparator m_comparator;
+
+    /* functions */
+    T&        slot(const size_t index);
+    void      grow();
+    void      migrate(size_t count);
+    void      release_old();
+    int       find_from_index(const size_t index, const T& item);
+    static T* allocate(const size_t capacity);
+};
+
+template <class T>
+incremental_vector<T>::incremental_vector(item_comparator comparator)
+    : m_capacity{ initial_vector_capacity }
+    , m_size{ 0 }
+    , m_array{ nullptr }
+    , m_old{ nullptr }
+    , m_old_size{ 0 }
+    , m_migrated{ 0 }
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+    {
+        throw std::invalid_argument("Comparator cannot be null");
+    }
+    m_array = allocate(m_capacity);
+}
+
+template <class T>
+incremental_vector<T>::~incremental_vector()
+{
+    for (size_t i = 0; i < m_size; ++i)
+        slot(i).~T();
+
+    if (m_old)
+        ::operator delete(m_old);
+    if (m_array)
+        ::operator delete(m_array);
+}
+
+template <class T>
+size_t incremental_vector<T>::size()
+{
+    return m_size;
+}
+
+template <class T>
+size_t incremental_vector<T>::capacity()
+{
+    return m_capacity;
+}
+
+template <class T>
+bool incremental_vector<T>::is_empty()
+{
+    return !m_size;
+}
+
+template <class T>
+bool incremental_vector<T>::is_migrating()
+{
+    return m_old != nullptr;
+}
+
+template <class T>
+T& incremental_vector<T>::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return slot(index);
+}
+
+/* Contiguous view of the items, completing any pending migration */
+template <class T>
+T* incremental_vector<T>::data()
+{
+    finish_migration();
+    return m_array;
+}
+
+template <class T>
+void incremental_vector<T>::push(const T& item)
+{
+    if (m_size >= m_capacity)
+        grow();
+
+    new (m_array + m_size) T(item);
+    m_size++;
+
+    migrate(incremental_vector_migration_step);
+}
+
+template <class T>
+void incremental_vector<T>::insert(const size_t index, const T& item)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    if (index == m_size)
+    {
+        push(item);
+        return;
+    }
+
+    finish_migration();
+    if (m_size >= m_capacity)
+    {
+        grow();
+        finish_migration();
+    }
+
+    new (m_array + m_size) T(*(m_array + m_size - 1));
+    for (size_t i = m_size - 1; i > index; --i)
+        *(m_array + i) = *(m_array + i - 1);
+
+    *(m_array + index) = item;
+    m_size++;
+}
+
+template <class T>
+void incremental_vector<T>::prepend(const T& item)
+{
+    insert(0, item);
+}
+
+template <class T>
+T incremental_vector<T>::pop()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    T& last = slot(m_size - 1);
+    T  ret  = last;
+    last.~T();
+    m_size--;
+
+    /* The popped item may still have been waiting in the old buffer */
+    if (m_old_size > m_size)
+        m_old_size = m_size;
+
+    migrate(incremental_vector_migration_step);
+    return ret;
+}
+
+template <class T>
+void incremental_vector<T>::erase_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to delete item.");
+
+    finish_migration();
+
+    for (size_t i = index; i + 1 < m_size; ++i)
+        *(m_array + i) = *(m_array + i + 1);
+
+    (m_array + m_size - 1)->~T();
+    m_size--;
+}
+
+template <class T>
+void incremental_vector<T>::remove(const T& item)
+{
+    int index = 0;
+    while (-1 != (index = find_from_index(index, item)))
+        erase_at(index);
+}
+
+template <class T>
+int incremental_vector<T>::find(const T& item)
+{
+    return find_from_index(0, item);
+}
+
+template <class T>
+void incremental_vector<T>::finish_migration()
+{
+    if (m_old)
+        migrate(m_old_size - m_migrated);
+}
+
+/* Items in [m_migrated, m_old_size) have not left the old buffer yet */
+template <class T>
+T& incremental_vector<T>::slot(const size_t index)
+{
+    if (index >= m_migrated && index < m_old_size)
+        return *(m_old + index);
+
+    return *(m_array + index);
+}
+
+/* Swaps in a buffer of twice the capacity without moving any item */
+template <class T>
+void incremental_vector<T>::grow()
+{
+    /* Cannot happen with the migration step above, kept as a safety net */
+    finish_migration();
+
+    T* new_array = allocate(m_capacity * 2);
+
+    m_old      = m_array;
+    m_old_size = m_size;
+    m_migrated = 0;
+    m_array    = new_array;
+    m_capacity *= 2;
+}
+
+template <class T>
+void incremental_vector<T>::migrate(size_t count)
+{
+    if (!m_old)
+        return;
+
+    for (; count && m_migrated < m_old_size; --count, ++m_migrated)
+    {
+        new (m_array + m_migrated) T(*(m_old + m_migrated));
+        (m_old + m_migrated)->~T();
+    }
+
+    if (m_migrated >= m_old_size)
+        release_old();
+}
+
+template <class T>
+void incremental_vector<T>::release_old()
+{
+    ::operator delete(m_old);
+    m_old      = nullptr;
+    m_old_size = 0;
+    m_migrated = 0;
+}
+
+template <class T>
+int incremental_vector<T>::find_from_index(const size_t index, const T& item)
+{
+    for (size_t i = index; i < m_size; ++i)
+    {
+        if (m_comparator(slot(i), item))
+            return i;
+    }
+
+    return -1;
+}
+
+template <class T>
+T* incremental_vector<T>::allocate(const size_t capacity)
+{
+    return static_cast<T*>(::operator new(capacity * sizeof(T)));
+}
+
+} // namespace orla
@@ -0,0 +1,391 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include "doubly_linked_list.hpp"
+
+namespace orla
+{
+
+struct lru_cache_stats
+{
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+};
+
+/**
+ * lru_cache - least recently used cache with O(1) get, put and eviction
+ *
+ * Entries sit in a doubly_linked_list ordered from most to least recently
+ * used and a hash index maps every key to its list node, so a hit is a
+ * lookup plus a relink. Capacity is counted in entries, or in bytes as
+ * reported by an entry_size callback.
+ */
+template <class K, class V, class Hash = std::hash<K>>
+class lru_cache
+{
+public:
+    typedef size_t (*entry_size)(const K& key, const V& value);
+
+    lru_cache(const size_t capacity);
+    lru_cache(const size_t capacity_bytes, entry_size size_of);
+    lru_cache(const lru_cache& cache) = delete;
+
+    size_t          size();
+    size_t          capacity();
+    size_t          used();
+    bool            is_empty();
+    lru_cache_stats stats();
+
+    bool get(const K& key, V& value);
+    V*   find(const K& key);
+    bool put(const K& key, const V& value);
+    bool erase(const K& key);
+    void clear();
+
+private:
+    /* data */
+    typedef struct entry
+    {
+        K      key;
+        V      value;
+        size_t cost;
+    } entry_t;
+
+    typedef typename doubly_linked_list<entry_t>::node_handle node_handle;
+
+    size_t                                   m_capacity;
+    size_t                                   m_used;
+    entry_size                               m_size_of;
+    doubly_linked_list<entry_t>              m_entries;
+    std::unordered_map<K, node_handle, Hash> m_index;
+    lru_cache_stats                          m_stats;
+
+    /* functions */
+    static bool   entry_comparator(const entry_t& a, const entry_t& b);
+    static size_t one_entry(const K& key, const V& value);
+    void          evict_until(const size_t capacity);
+};
+
+/**
+ * sharded_lru_cache - thread safe lru_cache split into independently locked shards
+ *
+ * Keys are spread over the shards by hash and every shard runs its own LRU
+ * order over an equal share of the capacity. Values are copied out under the
+ * shard lock, so there is no pointer returning find().
+ */
+template <class K, class V, class Hash = std::hash<K>>
+class sharded_lru_cache
+{
+public:
+    typedef typename lru_cache<K, V, Hash>::entry_size entry_size;
+
+    sharded_lru_cache(const size_t shards, const size_t capacity);
+    sharded_lru_cache(const size_t shards, const size_t capacity_bytes, entry_size size_of);
+    sharded_lru_cache(const sharded_lru_cache& cache) = delete;
+
+    size_t          shards();
+    size_t          size();
+    lru_cache_stats stats();
+
+    bool get(const K& key, V& value);
+    bool put(const K& key, const V& value);
+    bool erase(const K& key);
+    void clear();
+
+private:
+    /* data */
+    typedef struct shard
+    {
+        std::mutex                              mutex;
+        std::unique_ptr<lru_cache<K, V, Hash>> cache;
+    } shard_t;
+
+    size_t                     m_shard_count;
+    std::unique_ptr<shard_t[]> m_shards;
+    Hash                       m_hash;
+
+    /* functions */
+    shard_t& shard_for(const K& key);
+};
+
+template <class K, class V, class Hash>
+lru_cache<K, V, Hash>::lru_cache(const size_t capacity)
+    : lru_cache(capacity, one_entry)
+{
+}
+
+template <class K, class V, class Hash>
+lru_cache<K, V, Hash>::lru_cache(const size_t capacity_bytes, entry_size size_of)
+    : m_capacity{ capacity_bytes }
+    , m_used{ 0 }
+    , m_size_of{ size_of }
+    , m_entries{ entry_comparator }
+    , m_index{}
+    , m_stats{ 0, 0, 0 }
+{
+    if (!m_capacity)
+        throw std::invalid_argument("Cache capacity cannot be zero");
+
+    if (!m_size_of)
+        throw std::invalid_argument("Entry size function cannot be null");
+}
+
+template <class K, class V, class Hash>
+size_t lru_cache<K, V, Hash>::size()
+{
+    return m_entries.size();
+}
+
+template <class K, class V, class Hash>
+size_t lru_cache<K, V, Hash>::capacity()
+{
+    return m_capacity;
+}
+
+/* Capacity consumed by the cached entries, in entries or bytes */
+template <class K, class V, class Hash>
+size_t lru_cache<K, V, Hash>::used()
+{
+    return m_used;
+}
+
+template <class K, class V, class Hash>
+bool lru_cache<K, V, Hash>::is_empty()
+{
+    return m_entries.is_empty();
+}
+
+template <class K, class V, class Hash>
+lru_cache_stats lru_cache<K, V, Hash>::stats()
+{
+    return m_stats;
+}
+
+template <class K, class V, class Hash>
+bool lru_cache<K, V, Hash>::get(const K& key, V& value)
+{
+    V* found = find(key);
+    if (!found)
+        return false;
+
+    value = *found;
+    return true;
+}
+
+/* Returned pointer is valid until the next put(), erase() or clear() */
+template <class K, class V, class Hash>
+V* lru_cache<K, V, Hash>::find(const K& key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+    {
+        m_stats.misses++;
+        return nullptr;
+    }
+
+    m_stats.hits++;
+    m_entries.move_to_front(it->second);
+    return &m_entries.value_of(it->second).value;
+}
+
+/* Returns false when the entry alone exceeds the capacity and is not cached */
+template <class K, class V, class Hash>
+bool lru_cache<K, V, Hash>::put(const K& key, const V& value)
+{
+    size_t cost = m_size_of(key, value);
+    if (cost > m_capacity)
+    {
+        erase(key);
+        return false;
+    }
+
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        entry_t& current = m_entries.value_of(it->second);
+        m_used           = m_used - current.cost + cost;
+        current.value    = value;
+        current.cost     = cost;
+        m_entries.move_to_front(it->second);
+        evict_until(m_capacity);
+        return true;
+    }
+
+    evict_until(m_capacity - cost);
+
+    entry_t fresh;
+    fresh.key   = key;
+    fresh.value = value;
+    fresh.cost  = cost;
+    m_index.emplace(key, m_entries.push_front_node(fresh));
+    m_used += cost;
+    return true;
+}
+
+template <class K, class V, class Hash>
+bool lru_cache<K, V, Hash>::erase(const K& key)
+{
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+        return false;
+
+    m_used -= m_entries.value_of(it->second).cost;
+    m_entries.erase_node(it->second);
+    m_index.erase(it);
+    return true;
+}
+
+template <class K, class V, class Hash>
+void lru_cache<K, V, Hash>::clear()
+{
+    while (!m_entries.is_empty())
+        m_entries.pop_back();
+
+    m_index.clear();
+    m_used = 0;
+}
+
+template <class K, class V, class Hash>
+bool lru_cache<K, V, Hash>::entry_comparator(const entry_t& a, const entry_t& b)
+{
+    return a.key == b.key;
+}
+
+template <class K, class V, class Hash>
+size_t lru_cache<K, V, Hash>::one_entry(const K&, const V&)
+{
+    return 1;
+}
+
+template <class K, class V, class Hash>
+void lru_cache<K, V, Hash>::evict_until(const size_t capacity)
+{
+    while (m_used > capacity)
+    {
+        node_handle victim = m_entries.back_node();
+        entry_t&    lru    = m_entries.value_of(victim);
+
+        m_used -= lru.cost;
+        m_index.erase(lru.key);
+        m_entries.erase_node(victim);
+        m_stats.evictions++;
+    }
+}
+
+template <class K, class V, class Hash>
+sharded_lru_cache<K, V, Hash>::sharded_lru_cache(const size_t shards, const size_t capacity)
+    : sharded_lru_cache(shards, capacity, nullptr)
+{
+}
+
+template <class K, class V, class Hash>
+sharded_lru_cache<K, V, Hash>::sharded_lru_cache(const size_t shards,
+                                                 const size_t capacity_bytes,
+                                                 entry_size   size_of)
+    : m_shard_count{ shards }
+    , m_shards{ nullptr }
+    , m_hash{}
+{
+    if (!m_shard_count)
+        throw std::invalid_argument("Cache needs at least one shard");
+
+    if (capacity_bytes < m_shard_count)
+        throw std::invalid_argument("Cache capacity must cover every shard");
+
+    m_shards.reset(new shard_t[m_shard_count]);
+    for (size_t i = 0; i < m_shard_count; ++i)
+    {
+        /* The first shards absorb the remainder of the division */
+        size_t share = capacity_bytes / m_shard_count + (i < capacity_bytes % m_shard_count ? 1 : 0);
+        if (size_of)
+            m_shards[i].cache.reset(new lru_cache<K, V, Hash>(share, size_of));
+        else
+            m_shards[i].cache.reset(new lru_cache<K, V, Hash>(share));
+    }
+}
+
+template <class K, class V, class Hash>
+size_t sharded_lru_cache<K, V, Hash>::shards()
+{
+    return m_shard_count;
+}
+
+template <class K, class V, class Hash>
+size_t sharded_lru_cache<K, V, Hash>::size()
+{
+    size_t total = 0;
+    for (size_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        total += m_shards[i].cache->size();
+    }
+
+    return total;
+}
+
+template <class K, class V, class Hash>
+lru_cache_stats sharded_lru_cache<K, V, Hash>::stats()
+{
+    lru_cache_stats total{ 0, 0, 0 };
+    for (size_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        lru_cache_stats shard_stats = m_shards[i].cache->stats();
+        total.hits += shard_stats.hits;
+        total.misses += shard_stats.misses;
+        total.evictions += shard_stats.evictions;
+    }
+
+    return total;
+}
+
+template <class K, class V, class Hash>
+bool sharded_lru_cache<K, V, Hash>::get(const K& key, V& value)
+{
+    shard_t&                    target = shard_for(key);
+    std::lock_guard<std::mutex> lock(target.mutex);
+    return target.cache->get(key, value);
+}
+
+template <class K, class V, class Hash>
+bool sharded_lru_cache<K, V, Hash>::put(const K& key, const V& value)
+{
+    shard_t&                    target = shard_for(key);
+    std::lock_guard<std::mutex> lock(target.mutex);
+    return target.cache->put(key, value);
+}
+
+template <class K, class V, class Hash>
+bool sharded_lru_cache<K, V, Hash>::erase(const K& key)
+{
+    shard_t&                    target = shard_for(key);
+    std::lock_guard<std::mutex> lock(target.mutex);
+    return target.cache->erase(key);
+}
+
+template <class K, class V, class Hash>
+void sharded_lru_cache<K, V, Hash>::clear()
+{
+    for (size_t i = 0; i < m_shard_count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(m_shards[i].mutex);
+        m_shards[i].cache->clear();
+    }
+}
+
+template <class K, class V, class Hash>
+typename sharded_lru_cache<K, V, Hash>::shard_t& sharded_lru_cache<K, V, Hash>::shard_for(const K& key)
+{
+    /* Fibonacci hashing so weak std::hash values still spread over the shards */
+    uint64_t mixed = static_cast<uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ULL;
+    return m_shards[(mixed >> 32) % m_shard_count];
+}
+
+} // namespace orla
@@ -0,0 +1,417 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const uint64_t mmap_vector_magic       = 0x31564d414c524fULL; /* "ORLAMV1" */
+static const uint32_t mmap_vector_version     = 1;
+static const size_t   mmap_vector_data_offset = 64;
+
+struct mmap_vector_header
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t item_size;
+    uint64_t size;
+    uint64_t capacity;
+};
+
+enum class mmap_open_mode
+{
+    read_only,  /* existing file, mutations throw */
+    read_write, /* existing file, created when missing */
+    create      /* always start from an empty vector */
+};
+
+/**
+ * mmap_vector - vector whose items live in a memory mapped file
+ *
+ * The file starts with a mmap_vector_header followed by capacity() items at
+ * mmap_vector_data_offset. Size changes are written straight into the mapped
+ * header, so reopening the file restores the vector without reading it and
+ * pages are only faulted in when touched. Capacity doubles like orla::vector
+ * by extending the file and remapping it; the file never shrinks on its own.
+ */
+template <class T>
+class mmap_vector
+{
+    static_assert(std::is_trivially_copyable<T>::value, "mmap_vector items must be trivially copyable");
+
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    mmap_vector(const char* path, item_comparator comparator, mmap_open_mode mode = mmap_open_mode::read_write);
+    mmap_vector(const mmap_vector& vector) = delete;
+    ~mmap_vector();
+
+    size_t size();
+    size_t capacity();
+    bool   is_empty();
+    bool   is_read_only();
+
+    T&   at(const size_t index);
+    T*   data();
+    void push(const T& item);
+    void insert(const size_t index, const T& item);
+    void prepend(const T& item);
+    T    pop();
+    void erase_at(const size_t index);
+    void remove(const T& item);
+    int  find(const T& item);
+
+    void reserve(const size_t capacity);
+    void shrink_to_fit();
+    void flush(bool async = false);
+
+private:
+    /* data */
+    int                 m_fd;
+    bool                m_read_only;
+    void*               m_mapping;
+    size_t              m_mapped_bytes;
+    mmap_vector_header* m_header;
+    T*                  m_array;
+    item_comparator     m_comparator;
+
+    /* functions */
+    void          create();
+    void          validate(const size_t file_bytes);
+    void          map(const size_t bytes);
+    void          remap(const size_t new_capacity);
+    void          check_resize();
+    void          check_writable();
+    int           find_from_index(const size_t index, const T& item);
+    static size_t file_bytes(const size_t capacity);
+    static void   throw_errno(const char* what);
+};
+
+template <class T>
+mmap_vector<T>::mmap_vector(const char* path, item_comparator comparator, mmap_open_mode mode)
+    : m_fd{ -1 }
+    , m_read_only{ mode == mmap_open_mode::read_only }
+    , m_mapping{ nullptr }
+    , m_mapped_bytes{ 0 }
+    , m_header{ nullptr }
+    , m_array{ nullptr }
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+    {
+        throw std::invalid_argument("Comparator cannot be null");
+    }
+
+    int flags = m_read_only ? O_RDONLY : O_RDWR | O_CREAT;
+    if (mode == mmap_open_mode::create)
+        flags |= O_TRUNC;
+
+    m_fd = ::open(path, flags, 0644);
+    if (m_fd < 0)
+        throw_errno("Cannot open mmap_vector file");
+
+    struct stat st;
+    if (fstat(m_fd, &st) < 0)
+    {
+        ::close(m_fd);
+        throw_errno("Cannot stat mmap_vector file");
+    }
+
+    try
+    {
+        if (!st.st_size && !m_read_only)
+            create();
+        else
+            validate(st.st_size);
+    }
+    catch (...)
+    {
+        if (m_mapping)
+            munmap(m_mapping, m_mapped_bytes);
+        ::close(m_fd);
+        throw;
+    }
+}
+
+template <class T>
+mmap_vector<T>::~mmap_vector()
+{
+    if (m_mapping)
+        munmap(m_mapping, m_mapped_bytes);
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+template <class T>
+size_t mmap_vector<T>::size()
+{
+    return m_header->size;
+}
+
+template <class T>
+size_t mmap_vector<T>::capacity()
+{
+    return m_header->capacity;
+}
+
+template <class T>
+bool mmap_vector<T>::is_empty()
+{
+    return !m_header->size;
+}
+
+template <class T>
+bool mmap_vector<T>::is_read_only()
+{
+    return m_read_only;
+}
+
+template <class T>
+T& mmap_vector<T>::at(const size_t index)
+{
+    if (index >= m_header->size)
+        throw std::out_of_range("Out of range index");
+
+    return *(m_array + index);
+}
+
+template <class T>
+T* mmap_vector<T>::data()
+{
+    return m_array;
+}
+
+template <class T>
+void mmap_vector<T>::push(const T& item)
+{
+    check_writable();
+    check_resize();
+
+    *(m_array + m_header->size) = item;
+    m_header->size++;
+}
+
+template <class T>
+void mmap_vector<T>::insert(const size_t index, const T& item)
+{
+    if (index > m_header->size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    check_writable();
+    check_resize();
+
+    memmove(m_array + index + 1, m_array + index, (m_header->size - index) * sizeof(T));
+    *(m_array + index) = item;
+    m_header->size++;
+}
+
+template <class T>
+void mmap_vector<T>::prepend(const T& item)
+{
+    insert(0, item);
+}
+
+template <class T>
+T mmap_vector<T>::pop()
+{
+    if (!m_header->size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    check_writable();
+
+    m_header->size--;
+    return *(m_array + m_header->size);
+}
+
+template <class T>
+void mmap_vector<T>::erase_at(const size_t index)
+{
+    if (index >= m_header->size)
+        throw std::out_of_range("Out of range index to delete item.");
+
+    check_writable();
+
+    memmove(m_array + index, m_array + index + 1, (m_header->size - index - 1) * sizeof(T));
+    m_header->size--;
+}
+
+template <class T>
+void mmap_vector<T>::remove(const T& item)
+{
+    check_writable();
+
+    int index = 0;
+    while (-1 != (index = find_from_index(index, item)))
+        erase_at(index);
+}
+
+template <class T>
+int mmap_vector<T>::find(const T& item)
+{
+    return find_from_index(0, item);
+}
+
+template <class T>
+void mmap_vector<T>::reserve(const size_t capacity)
+{
+    check_writable();
+
+    if (capacity > m_header->capacity)
+        remap(capacity);
+}
+
+template <class T>
+void mmap_vector<T>::shrink_to_fit()
+{
+    check_writable();
+
+    size_t capacity = m_header->size > initial_vector_capacity ? m_header->size : initial_vector_capacity;
+    if (capacity < m_header->capacity)
+        remap(capacity);
+}
+
+/* Writes dirty pages back to the file, waiting for completion unless async */
+template <class T>
+void mmap_vector<T>::flush(bool async)
+{
+    if (m_read_only)
+        return;
+
+    size_t bytes = file_bytes(m_header->size);
+    if (msync(m_mapping, bytes < m_mapped_bytes ? bytes : m_mapped_bytes, async ? MS_ASYNC : MS_SYNC) < 0)
+        throw_errno("Cannot flush mmap_vector");
+}
+
+template <class T>
+void mmap_vector<T>::create()
+{
+    size_t bytes = file_bytes(initial_vector_capacity);
+    if (ftruncate(m_fd, bytes) < 0)
+        throw_errno("Cannot size mmap_vector file");
+
+    map(bytes);
+
+    m_header->magic     = mmap_vector_magic;
+    m_header->version   = mmap_vector_version;
+    m_header->item_size = sizeof(T);
+    m_header->size      = 0;
+    m_header->capacity  = initial_vector_capacity;
+}
+
+template <class T>
+void mmap_vector<T>::validate(const size_t bytes)
+{
+    if (bytes < mmap_vector_data_offset)
+        throw std::runtime_error("File too small to be an mmap_vector");
+
+    map(bytes);
+
+    if (m_header->magic != mmap_vector_magic)
+        throw std::runtime_error("File is not an mmap_vector");
+    if (m_header->version != mmap_vector_version)
+        throw std::runtime_error("Unsupported mmap_vector version");
+    if (m_header->item_size != sizeof(T))
+        throw std::runtime_error("mmap_vector item size does not match");
+    if (m_header->capacity > (SIZE_MAX - mmap_vector_data_offset) / sizeof(T))
+        throw std::runtime_error("Corrupt mmap_vector header");
+    if (m_header->size > m_header->capacity || file_bytes(m_header->capacity) > bytes)
+        throw std::runtime_error("Corrupt mmap_vector header");
+}
+
+template <class T>
+void mmap_vector<T>::map(const size_t bytes)
+{
+    int   prot    = m_read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* mapping = mmap(nullptr, bytes, prot, MAP_SHARED, m_fd, 0);
+    if (mapping == MAP_FAILED)
+        throw_errno("Cannot map mmap_vector file");
+
+    m_mapping      = mapping;
+    m_mapped_bytes = bytes;
+    m_header       = static_cast<mmap_vector_header*>(m_mapping);
+    m_array        = reinterpret_cast<T*>(static_cast<char*>(m_mapping) + mmap_vector_data_offset);
+}
+
+template <class T>
+void mmap_vector<T>::remap(const size_t new_capacity)
+{
+    if (new_capacity < m_header->size)
+        throw std::logic_error("Loss of data due to resizing");
+
+    size_t bytes = file_bytes(new_capacity);
+
+    /* Grow the file before the mapping, shrink the mapping before the file */
+    if (bytes > m_mapped_bytes && ftruncate(m_fd, bytes) < 0)
+        throw_errno("Cannot grow mmap_vector file");
+
+#ifdef MREMAP_MAYMOVE
+    void* mapping = mremap(m_mapping, m_mapped_bytes, bytes, MREMAP_MAYMOVE);
+    if (mapping == MAP_FAILED)
+        throw_errno("Cannot remap mmap_vector file");
+
+    m_mapping      = mapping;
+    m_mapped_bytes = bytes;
+    m_header       = static_cast<mmap_vector_header*>(m_mapping);
+    m_array        = reinterpret_cast<T*>(static_cast<char*>(m_mapping) + mmap_vector_data_offset);
+#else
+    munmap(m_mapping, m_mapped_bytes);
+    m_mapping = nullptr;
+    map(bytes);
+#endif
+
+    if (bytes < file_bytes(m_header->capacity) && ftruncate(m_fd, bytes) < 0)
+        throw_errno("Cannot shrink mmap_vector file");
+
+    m_header->capacity = new_capacity;
+}
+
+template <class T>
+void mmap_vector<T>::check_resize()
+{
+    if (m_header->size >= m_header->capacity)
+        remap(m_header->capacity * 2);
+}
+
+template <class T>
+void mmap_vector<T>::check_writable()
+{
+    if (m_read_only)
+        throw std::logic_error("mmap_vector is opened read-only");
+}
+
+template <class T>
+int mmap_vector<T>::find_from_index(const size_t index, const T& item)
+{
+    for (size_t i = index; i < m_header->size; ++i)
+    {
+        if (m_comparator(*(m_array + i), item))
+            return i;
+    }
+
+    return -1;
+}
+
+template <class T>
+size_t mmap_vector<T>::file_bytes(const size_t capacity)
+{
+    return mmap_vector_data_offset + capacity * sizeof(T);
+}
+
+template <class T>
+void mmap_vector<T>::throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace orla
@@ -0,0 +1,487 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "vector.hpp"
+
+namespace orla
+{
+
+/* Values per block of sorted_id_vector, each block stores its first value and 127 deltas */
+static const size_t sorted_id_block_size = 128;
+
+namespace detail
+{
+
+inline uint64_t low_bits_mask(const size_t bits)
+{
+    return bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+}
+
+/* Bits needed by value, zero for zero */
+inline size_t bit_width(const uint64_t value)
+{
+    return value ? 64 - __builtin_clzll(value) : 0;
+}
+
+/* Reads the bits wide value starting at bit of words; a value may straddle two words */
+inline uint64_t unpack_bits(const uint64_t* words, const size_t bit, const size_t bits)
+{
+    if (!bits)
+        return 0;
+
+    const uint64_t* word  = words + bit / 64;
+    size_t          shift = bit % 64;
+    uint64_t        value = *word >> shift;
+    if (shift + bits > 64)
+        value |= *(word + 1) << (64 - shift);
+
+    return value & low_bits_mask(bits);
+}
+
+/*
+ * Branch-free unpack_bits for bits >= 1. The high word is the one holding
+ * the last bit of the value, which is the low word again when the value
+ * does not straddle; its bits then land above bits and are masked away.
+ * Nothing past the value is read.
+ */
+inline uint64_t unpack_window(const uint64_t* words, const size_t bit, const size_t bits)
+{
+    size_t   shift = bit % 64;
+    uint64_t low   = *(words + bit / 64) >> shift;
+    uint64_t high  = (*(words + (bit + bits - 1) / 64) << 1) << (63 - shift);
+
+    return (low | high) & low_bits_mask(bits);
+}
+
+/* Overwrites the bits wide value starting at bit of words */
+inline void pack_bits(uint64_t* words, const size_t bit, const size_t bits, const uint64_t value)
+{
+    if (!bits)
+        return;
+
+    uint64_t* word  = words + bit / 64;
+    size_t    shift = bit % 64;
+    uint64_t  mask  = low_bits_mask(bits);
+
+    *word = (*word & ~(mask << shift)) | (value << shift);
+    if (shift + bits > 64)
+    {
+        size_t spilled = 64 - shift;
+        *(word + 1)    = (*(word + 1) & ~(mask >> spilled)) | (value >> spilled);
+    }
+}
+
+} // namespace detail
+
+/**
+ * packed_vector - vector of unsigned integers stored in Bits bits each
+ *
+ * Items are packed back to back in 64-bit words of an orla::vector, so a
+ * column of values below 2^Bits takes Bits / 64 of a uint64_t vector. at()
+ * is O(1) with at most two word reads. Every 64 items fill exactly Bits
+ * words, and decode() unpacks such aligned groups as 64 expanded
+ * unpack_window() calls whose word offsets and shifts are all known at
+ * compile time: straight line code without branches or loop overhead, a
+ * few times faster than unpacking item by item. The shifts stay scalar as
+ * every item needs its own; the compiler only pairs some of the stores.
+ * decode() handles the unaligned edges item by item.
+ */
+template <size_t Bits>
+class packed_vector
+{
+    static_assert(Bits >= 1 && Bits <= 64, "packed_vector items need between 1 and 64 bits");
+
+public:
+    packed_vector();
+    packed_vector(const packed_vector& vector) = delete;
+
+    size_t size();
+    bool   is_empty();
+    size_t bytes();
+
+    uint64_t at(const size_t index);
+    void     set(const size_t index, const uint64_t value);
+    void     push(const uint64_t value);
+    uint64_t pop();
+    template <class U>
+    void decode(const size_t first, const size_t count, U* out);
+
+private:
+    /* data */
+    typedef vector<uint64_t, default_allocator<uint64_t>, null_stats, unchecked_bounds> words_t;
+    typedef std::make_index_sequence<64>                                                 group_indices;
+    typedef int                                                                          expand[];
+
+    words_t m_words;
+    size_t  m_size;
+
+    /* functions */
+    void            resize_words(const size_t size);
+    template <class U, size_t... I>
+    static void     decode_group(const uint64_t* words, U* out, std::index_sequence<I...>);
+    static uint64_t mask();
+    static bool     word_comparator(const uint64_t& a, const uint64_t& b);
+};
+
+/**
+ * sorted_id_vector - compressed vector of non-decreasing 64-bit ids
+ *
+ * Ids are grouped in blocks of sorted_id_block_size. A block header keeps
+ * the first id as frame of reference, the bit width of the largest delta
+ * between neighbours and the offset of the block payload, where the 127
+ * deltas are bit packed at that width. Dense ids therefore take a few bits
+ * each. The headers double as skip pointers: find() and lower_bound()
+ * binary search them for the block that may hold the id and decode only
+ * that block. The last, partial block is kept uncompressed until it fills.
+ *
+ * at() decodes the deltas of its block up to index; scans should use
+ * decode(), which unpacks whole blocks.
+ */
+class sorted_id_vector
+{
+public:
+    sorted_id_vector();
+    sorted_id_vector(const sorted_id_vector& vector) = delete;
+
+    size_t size();
+    bool   is_empty();
+    size_t bytes();
+
+    uint64_t at(const size_t index);
+    void     push(const uint64_t id);
+    int      find(const uint64_t id);
+    size_t   lower_bound(const uint64_t id);
+    void     decode(const size_t first, const size_t count, uint64_t* out);
+
+private:
+    /* data */
+    typedef struct block_header
+    {
+        uint64_t first;
+        uint64_t offset; /* in words of m_payload */
+        uint64_t bits;
+    } block_header_t;
+
+    typedef vector<block_header_t, default_allocator<block_header_t>, null_stats, unchecked_bounds> blocks_t;
+    typedef vector<uint64_t, default_allocator<uint64_t>, null_stats, unchecked_bounds>             words_t;
+
+    blocks_t m_blocks;
+    words_t  m_payload;
+    uint64_t m_tail[sorted_id_block_size];
+    size_t   m_tail_size;
+    size_t   m_size;
+    uint64_t m_last;
+
+    /* functions */
+    void        compress_tail();
+    void        decode_block(const size_t block, uint64_t* out);
+    size_t      find_block(const uint64_t id);
+    static bool header_comparator(const block_header_t& a, const block_header_t& b);
+    static bool word_comparator(const uint64_t& a, const uint64_t& b);
+};
+
+template <size_t Bits>
+packed_vector<Bits>::packed_vector()
+    : m_words{ word_comparator }
+    , m_size{ 0 }
+{
+}
+
+template <size_t Bits>
+size_t packed_vector<Bits>::size()
+{
+    return m_size;
+}
+
+template <size_t Bits>
+bool packed_vector<Bits>::is_empty()
+{
+    return !m_size;
+}
+
+template <size_t Bits>
+size_t packed_vector<Bits>::bytes()
+{
+    return m_words.size() * sizeof(uint64_t);
+}
+
+template <size_t Bits>
+uint64_t packed_vector<Bits>::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return detail::unpack_bits(m_words.data(), index * Bits, Bits);
+}
+
+template <size_t Bits>
+void packed_vector<Bits>::set(const size_t index, const uint64_t value)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+    if (value > mask())
+        throw std::invalid_argument("Value does not fit in the item bits");
+
+    detail::pack_bits(m_words.data(), index * Bits, Bits, value);
+}
+
+template <size_t Bits>
+void packed_vector<Bits>::push(const uint64_t value)
+{
+    if (value > mask())
+        throw std::invalid_argument("Value does not fit in the item bits");
+
+    resize_words(m_size + 1);
+    detail::pack_bits(m_words.data(), m_size * Bits, Bits, value);
+    m_size++;
+}
+
+template <size_t Bits>
+uint64_t packed_vector<Bits>::pop()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    uint64_t ret = detail::unpack_bits(m_words.data(), (m_size - 1) * Bits, Bits);
+    detail::pack_bits(m_words.data(), (m_size - 1) * Bits, Bits, 0);
+    m_size--;
+
+    resize_words(m_size);
+    return ret;
+}
+
+/* Writes the items [first, first + count) to out */
+template <size_t Bits>
+template <class U>
+void packed_vector<Bits>::decode(const size_t first, const size_t count, U* out)
+{
+    if (first > m_size || count > m_size - first)
+        throw std::out_of_range("Out of range items to decode");
+
+    const uint64_t* words = m_words.data();
+    size_t          index = first;
+    size_t          last  = first + count;
+
+    for (; index < last && index % 64; ++index)
+        *(out++) = static_cast<U>(detail::unpack_bits(words, index * Bits, Bits));
+
+    for (; index + 64 <= last; index += 64, out += 64)
+        decode_group(words + index / 64 * Bits, out, group_indices());
+
+    for (; index < last; ++index)
+        *(out++) = static_cast<U>(detail::unpack_bits(words, index * Bits, Bits));
+}
+
+/* Keeps exactly the words holding size items, the ones dropped are zero */
+template <size_t Bits>
+void packed_vector<Bits>::resize_words(const size_t size)
+{
+    size_t words = (size * Bits + 63) / 64;
+    while (m_words.size() < words)
+        m_words.push(0);
+    while (m_words.size() > words)
+        m_words.pop_unchecked();
+}
+
+/* Unpacks the 64 items stored in the Bits words from words, one expansion per item */
+template <size_t Bits>
+template <class U, size_t... I>
+void packed_vector<Bits>::decode_group(const uint64_t* words, U* out, std::index_sequence<I...>)
+{
+    (void)expand{ 0, (out[I] = static_cast<U>(detail::unpack_window(words, I * Bits, Bits)), 0)... };
+}
+
+template <size_t Bits>
+uint64_t packed_vector<Bits>::mask()
+{
+    return detail::low_bits_mask(Bits);
+}
+
+template <size_t Bits>
+bool packed_vector<Bits>::word_comparator(const uint64_t& a, const uint64_t& b)
+{
+    return a == b;
+}
+
+inline sorted_id_vector::sorted_id_vector()
+    : m_blocks{ header_comparator }
+    , m_payload{ word_comparator }
+    , m_tail_size{ 0 }
+    , m_size{ 0 }
+    , m_last{ 0 }
+{
+}
+
+inline size_t sorted_id_vector::size()
+{
+    return m_size;
+}
+
+inline bool sorted_id_vector::is_empty()
+{
+    return !m_size;
+}
+
+inline size_t sorted_id_vector::bytes()
+{
+    return m_blocks.size() * sizeof(block_header_t) + m_payload.size() * sizeof(uint64_t) + sizeof(m_tail);
+}
+
+inline uint64_t sorted_id_vector::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    size_t block    = index / sorted_id_block_size;
+    size_t position = index % sorted_id_block_size;
+    if (block == m_blocks.size())
+        return m_tail[position];
+
+    block_header_t& header = m_blocks[block];
+    const uint64_t* deltas = m_payload.data() + header.offset;
+    uint64_t        id     = header.first;
+    for (size_t i = 0; i < position; ++i)
+        id += detail::unpack_bits(deltas, i * header.bits, header.bits);
+
+    return id;
+}
+
+inline void sorted_id_vector::push(const uint64_t id)
+{
+    if (id < m_last)
+        throw std::invalid_argument("Ids must be pushed in non-decreasing order");
+
+    m_tail[m_tail_size++] = id;
+    m_last                = id;
+    m_size++;
+
+    if (m_tail_size == sorted_id_block_size)
+        compress_tail();
+}
+
+inline int sorted_id_vector::find(const uint64_t id)
+{
+    size_t index = lower_bound(id);
+    if (index == m_size || at(index) != id)
+        return -1;
+
+    return index;
+}
+
+/* Index of the first id not less than id, size() when there is none */
+inline size_t sorted_id_vector::lower_bound(const uint64_t id)
+{
+    size_t block = find_block(id);
+
+    uint64_t ids[sorted_id_block_size];
+    size_t   count = block < m_blocks.size() ? sorted_id_block_size : m_tail_size;
+    if (block < m_blocks.size())
+        decode_block(block, ids);
+    else
+        std::copy(m_tail, m_tail + m_tail_size, ids);
+
+    size_t position = std::lower_bound(ids, ids + count, id) - ids;
+    return block * sorted_id_block_size + position;
+}
+
+/* Writes the ids [first, first + count) to out, a block at a time */
+inline void sorted_id_vector::decode(const size_t first, const size_t count, uint64_t* out)
+{
+    if (first > m_size || count > m_size - first)
+        throw std::out_of_range("Out of range items to decode");
+
+    uint64_t ids[sorted_id_block_size];
+    size_t   index = first;
+    size_t   last  = first + count;
+    while (index < last)
+    {
+        size_t block    = index / sorted_id_block_size;
+        size_t position = index % sorted_id_block_size;
+        size_t taken    = std::min(sorted_id_block_size - position, last - index);
+
+        if (block == m_blocks.size())
+        {
+            std::copy(m_tail + position, m_tail + position + taken, out);
+        }
+        else if (!position && taken == sorted_id_block_size)
+        {
+            decode_block(block, out);
+        }
+        else
+        {
+            decode_block(block, ids);
+            std::copy(ids + position, ids + position + taken, out);
+        }
+
+        index += taken;
+        out += taken;
+    }
+}
+
+/* Frames the full tail on its first id and bit packs its deltas at the width of the largest */
+inline void sorted_id_vector::compress_tail()
+{
+    uint64_t largest = 0;
+    for (size_t i = 1; i < sorted_id_block_size; ++i)
+        largest = std::max(largest, m_tail[i] - m_tail[i - 1]);
+
+    block_header_t header = { m_tail[0], m_payload.size(), detail::bit_width(largest) };
+    size_t         words  = ((sorted_id_block_size - 1) * header.bits + 63) / 64;
+    for (size_t i = 0; i < words; ++i)
+        m_payload.push(0);
+
+    uint64_t* deltas = m_payload.data() + header.offset;
+    for (size_t i = 1; i < sorted_id_block_size; ++i)
+        detail::pack_bits(deltas, (i - 1) * header.bits, header.bits, m_tail[i] - m_tail[i - 1]);
+
+    m_blocks.push(header);
+    m_tail_size = 0;
+}
+
+inline void sorted_id_vector::decode_block(const size_t block, uint64_t* out)
+{
+    block_header_t& header = m_blocks[block];
+    const uint64_t* deltas = m_payload.data() + header.offset;
+
+    out[0] = header.first;
+    for (size_t i = 1; i < sorted_id_block_size; ++i)
+        out[i] = out[i - 1] + detail::unpack_bits(deltas, (i - 1) * header.bits, header.bits);
+}
+
+/*
+ * Binary searches the block headers, the tail counting as one more block,
+ * for the first block whose first id is not less than id and returns the
+ * block before it, which is the first that may hold id.
+ */
+inline size_t sorted_id_vector::find_block(const uint64_t id)
+{
+    size_t low  = 0;
+    size_t high = m_blocks.size() + (m_tail_size ? 1 : 0);
+    while (low < high)
+    {
+        size_t   middle = low + (high - low) / 2;
+        uint64_t first  = middle < m_blocks.size() ? m_blocks[middle].first : m_tail[0];
+        if (first < id)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return low ? low - 1 : 0;
+}
+
+inline bool sorted_id_vector::header_comparator(const block_header_t& a, const block_header_t& b)
+{
+    return a.offset == b.offset;
+}
+
+inline bool sorted_id_vector::word_comparator(const uint64_t& a, const uint64_t& b)
+{
+    return a == b;
+}
+
+} // namespace orla
@@ -0,0 +1,439 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const size_t default_grain_size = 1 << 14;
+
+/**
+ * thread_pool - fixed set of workers executing indexed tasks
+ *
+ * run() hands out task indices dynamically and returns once all of them
+ * completed. The calling thread takes part in the work, so a pool of size 1
+ * spawns no threads. Nested calls from inside a task run serially.
+ */
+class thread_pool
+{
+public:
+    thread_pool(const size_t threads);
+    thread_pool(const thread_pool& pool) = delete;
+    ~thread_pool();
+
+    size_t size();
+    void   run(const size_t tasks, const std::function<void(size_t)>& fn);
+
+    static thread_pool& shared();
+
+private:
+    /* data */
+    size_t                             m_threads;
+    std::unique_ptr<std::thread[]>     m_workers;
+    std::mutex                         m_submit_mutex;
+    std::mutex                         m_mutex;
+    std::condition_variable            m_wake;
+    std::condition_variable            m_done;
+    const std::function<void(size_t)>* m_job;
+    size_t                             m_tasks;
+    std::atomic<size_t>                m_next;
+    size_t                             m_active;
+    size_t                             m_generation;
+    bool                               m_stopping;
+    std::exception_ptr                 m_error;
+
+    /* functions */
+    void         worker();
+    void         work();
+    static bool& in_worker();
+};
+
+struct parallel_options
+{
+    size_t       grain_size = default_grain_size;
+    thread_pool* pool       = nullptr;
+};
+
+namespace parallel
+{
+
+template <class T, class A, class S, class C, class F>
+void for_each(vector<T, A, S, C>& vec, F fn, const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class F>
+void transform(vector<T, A, S, C>& vec, F fn, const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class U, class B, class R, class D, class F>
+void transform(vector<T, A, S, C>&     src,
+               vector<U, B, R, D>&     dst,
+               F                       fn,
+               const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class Op>
+T reduce(vector<T, A, S, C>& vec, T init, Op op, const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class Pred>
+size_t count_if(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class Pred>
+int find_first(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options = parallel_options());
+
+template <class T, class A, class S, class C, class Pred>
+size_t remove_if(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options = parallel_options());
+
+namespace detail
+{
+
+/* Splits [0, size) into at most a few chunks per thread, each at least grain_size long */
+class chunking
+{
+public:
+    chunking(const size_t size, const parallel_options& options)
+        : m_size{ size }
+        , m_pool{ options.pool ? *options.pool : thread_pool::shared() }
+        , m_chunks{ 1 }
+    {
+        size_t grain = options.grain_size ? options.grain_size : 1;
+        if (m_pool.size() > 1 && m_size > grain)
+        {
+            m_chunks         = (m_size + grain - 1) / grain;
+            size_t max_chunk = m_pool.size() * 4;
+            if (m_chunks > max_chunk)
+                m_chunks = max_chunk;
+        }
+    }
+
+    size_t chunks()
+    {
+        return m_chunks;
+    }
+    size_t begin(const size_t chunk)
+    {
+        return m_size * chunk / m_chunks;
+    }
+    size_t end(const size_t chunk)
+    {
+        return m_size * (chunk + 1) / m_chunks;
+    }
+    bool is_serial()
+    {
+        return m_chunks == 1;
+    }
+    void run(const std::function<void(size_t)>& fn)
+    {
+        m_pool.run(m_chunks, fn);
+    }
+
+private:
+    size_t       m_size;
+    thread_pool& m_pool;
+    size_t       m_chunks;
+};
+
+} // namespace detail
+
+template <class T, class A, class S, class C, class F>
+void for_each(vector<T, A, S, C>& vec, F fn, const parallel_options& options)
+{
+    T*               array = vec.data();
+    detail::chunking chunks(vec.size(), options);
+
+    chunks.run([&](size_t chunk) {
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+            fn(*(array + i));
+    });
+}
+
+template <class T, class A, class S, class C, class F>
+void transform(vector<T, A, S, C>& vec, F fn, const parallel_options& options)
+{
+    for_each(vec, [&](T& item) { item = fn(item); }, options);
+}
+
+/* Appends fn(item) for every item of src to dst */
+template <class T, class A, class S, class C, class U, class B, class R, class D, class F>
+void transform(vector<T, A, S, C>& src, vector<U, B, R, D>& dst, F fn, const parallel_options& options)
+{
+    if (static_cast<void*>(&src) == static_cast<void*>(&dst))
+        throw std::invalid_argument("Use the in-place transform to write into the source vector");
+
+    T*               in  = src.data();
+    U*               out = dst.extend(src.size());
+    detail::chunking chunks(src.size(), options);
+
+    chunks.run([&](size_t chunk) {
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+            *(out + i) = fn(*(in + i));
+    });
+}
+
+/* op must be associative, chunk results are combined in index order */
+template <class T, class A, class S, class C, class Op>
+T reduce(vector<T, A, S, C>& vec, T init, Op op, const parallel_options& options)
+{
+    if (vec.is_empty())
+        return init;
+
+    T*               array = vec.data();
+    detail::chunking chunks(vec.size(), options);
+    std::unique_ptr<T[]> partial(new T[chunks.chunks()]);
+
+    chunks.run([&](size_t chunk) {
+        size_t i   = chunks.begin(chunk);
+        T      acc = *(array + i);
+        for (++i; i < chunks.end(chunk); ++i)
+            acc = op(acc, *(array + i));
+        partial[chunk] = acc;
+    });
+
+    for (size_t chunk = 0; chunk < chunks.chunks(); ++chunk)
+        init = op(init, partial[chunk]);
+
+    return init;
+}
+
+template <class T, class A, class S, class C, class Pred>
+size_t count_if(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options)
+{
+    T*                  array = vec.data();
+    detail::chunking    chunks(vec.size(), options);
+    std::atomic<size_t> count{ 0 };
+
+    chunks.run([&](size_t chunk) {
+        size_t local = 0;
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+            local += pred(*(array + i)) ? 1 : 0;
+        count += local;
+    });
+
+    return count;
+}
+
+/* Returns the lowest index matching pred, or -1. Chunks past a match are skipped */
+template <class T, class A, class S, class C, class Pred>
+int find_first(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options)
+{
+    static const size_t check_interval = 1024;
+
+    T*                  array = vec.data();
+    size_t              size  = vec.size();
+    detail::chunking    chunks(size, options);
+    std::atomic<size_t> found{ size };
+
+    chunks.run([&](size_t chunk) {
+        size_t end = chunks.end(chunk);
+        for (size_t i = chunks.begin(chunk); i < end; ++i)
+        {
+            if (!(i % check_interval) && found.load(std::memory_order_relaxed) < i)
+                return;
+
+            if (pred(*(array + i)))
+            {
+                size_t current = found.load();
+                while (i < current && !found.compare_exchange_weak(current, i))
+                    ;
+                return;
+            }
+        }
+    });
+
+    return found == size ? -1 : (int)found;
+}
+
+/*
+ * Stable removal of every item matching pred. Each chunk counts its survivors,
+ * a prefix sum over the counts gives every chunk its output offset and the
+ * survivors are compacted into a scratch buffer before being copied back.
+ * Returns the number of removed items.
+ */
+template <class T, class A, class S, class C, class Pred>
+size_t remove_if(vector<T, A, S, C>& vec, Pred pred, const parallel_options& options)
+{
+    T*                       array = vec.data();
+    size_t                   size  = vec.size();
+    detail::chunking         chunks(size, options);
+    std::unique_ptr<bool[]>  keep(new bool[size]);
+    std::unique_ptr<size_t[]> offset(new size_t[chunks.chunks() + 1]);
+
+    chunks.run([&](size_t chunk) {
+        size_t kept = 0;
+        for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+        {
+            keep[i] = !pred(*(array + i));
+            kept += keep[i] ? 1 : 0;
+        }
+        offset[chunk + 1] = kept;
+    });
+
+    offset[0] = 0;
+    for (size_t chunk = 1; chunk <= chunks.chunks(); ++chunk)
+        offset[chunk] += offset[chunk - 1];
+
+    size_t kept = offset[chunks.chunks()];
+    if (kept == size)
+        return 0;
+
+    if (chunks.is_serial())
+    {
+        size_t out = 0;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (keep[i])
+                *(array + out++) = *(array + i);
+        }
+    }
+    else
+    {
+        std::unique_ptr<T[]> scratch(new T[kept]);
+
+        chunks.run([&](size_t chunk) {
+            size_t out = offset[chunk];
+            for (size_t i = chunks.begin(chunk); i < chunks.end(chunk); ++i)
+            {
+                if (keep[i])
+                    scratch[out++] = *(array + i);
+            }
+        });
+
+        chunks.run([&](size_t chunk) {
+            for (size_t i = offset[chunk]; i < offset[chunk + 1]; ++i)
+                *(array + i) = scratch[i];
+        });
+    }
+
+    vec.truncate(kept);
+
+    return size - kept;
+}
+
+} // namespace parallel
+
+inline thread_pool::thread_pool(const size_t threads)
+    : m_threads{ threads ? threads : 1 }
+    , m_workers{ nullptr }
+    , m_job{ nullptr }
+    , m_tasks{ 0 }
+    , m_next{ 0 }
+    , m_active{ 0 }
+    , m_generation{ 0 }
+    , m_stopping{ false }
+{
+    m_workers.reset(new std::thread[m_threads - 1]);
+    for (size_t i = 0; i < m_threads - 1; ++i)
+        m_workers[i] = std::thread(&thread_pool::worker, this);
+}
+
+inline thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (size_t i = 0; i < m_threads - 1; ++i)
+        m_workers[i].join();
+}
+
+inline size_t thread_pool::size()
+{
+    return m_threads;
+}
+
+inline void thread_pool::run(const size_t tasks, const std::function<void(size_t)>& fn)
+{
+    if (m_threads == 1 || tasks <= 1 || in_worker())
+    {
+        for (size_t i = 0; i < tasks; ++i)
+            fn(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(m_submit_mutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job    = &fn;
+        m_tasks  = tasks;
+        m_next   = 0;
+        m_active = m_threads - 1;
+        m_error  = nullptr;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    in_worker() = true;
+    work();
+    in_worker() = false;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return !m_active; });
+    m_job = nullptr;
+
+    if (m_error)
+        std::rethrow_exception(m_error);
+}
+
+inline thread_pool& thread_pool::shared()
+{
+    static thread_pool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+inline void thread_pool::worker()
+{
+    in_worker()     = true;
+    size_t seen_gen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen_gen; });
+            if (m_stopping)
+                return;
+            seen_gen = m_generation;
+        }
+
+        work();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!--m_active)
+            m_done.notify_one();
+    }
+}
+
+inline void thread_pool::work()
+{
+    size_t task;
+    while ((task = m_next++) < m_tasks)
+    {
+        try
+        {
+            (*m_job)(task);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+            m_next = m_tasks;
+        }
+    }
+}
+
+inline bool& thread_pool::in_worker()
+{
+    static thread_local bool flag = false;
+    return flag;
+}
+
+} // namespace orla
@@ -0,0 +1,873 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+
+namespace orla
+{
+
+static const size_t persistent_vector_bits  = 5;
+static const size_t persistent_vector_width = 1 << persistent_vector_bits;
+
+/* Nodes a concatenation may leave beyond the optimum, bounding the extra search steps */
+static const size_t persistent_vector_extra_nodes = 2;
+
+/**
+ * persistent_vector - vector with O(1) snapshots through structural sharing
+ *
+ * Items live in a relaxed radix balanced (RRB) tree of 32-way nodes plus a
+ * tail leaf of up to 32 items. Copying the vector, or calling snapshot(),
+ * only takes a reference on the root and the tail, so a reader keeps a
+ * consistent view while the writer goes on. Every node is reference counted
+ * with atomics, so snapshots may be handed to and dropped from other
+ * threads; a single persistent_vector object still needs external locking.
+ *
+ * Mutations copy the path from the root to the touched leaf, except for
+ * nodes whose count shows this vector is their only owner, which are edited
+ * in place. A vector that shares nothing therefore behaves as a transient:
+ * a batch of pushes after a snapshot copies the right spine once and then
+ * runs in place.
+ *
+ * push() and pop() work on the tail and touch the tree once per 32 items.
+ * at() descends log32(n) levels, each guessing the child by radix and
+ * scanning forward the size table of relaxed nodes. insert() and erase_at()
+ * split the tree around the index and concatenate the halves back,
+ * rebalancing only the nodes along the seam, in O(log n). append()
+ * concatenates two vectors the same way.
+ */
+template <class T>
+class persistent_vector
+{
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    persistent_vector(item_comparator comparator);
+    persistent_vector(const persistent_vector& vector);
+    persistent_vector& operator=(const persistent_vector& vector);
+    ~persistent_vector();
+
+    size_t size();
+    bool   is_empty();
+
+    const T&          at(const size_t index);
+    void              set(const size_t index, const T& item);
+    void              push(const T& item);
+    T                 pop();
+    void              insert(const size_t index, const T& item);
+    void              erase_at(const size_t index);
+    void              append(const persistent_vector& vector);
+    void              clear();
+    int               find(const T& item);
+    persistent_vector snapshot();
+
+private:
+    /* data */
+    struct node
+    {
+        node()
+            : refs{ 1 }
+            , count{ 0 }
+        {
+        }
+
+        std::atomic<size_t> refs;
+        size_t              count;
+    };
+
+    struct leaf : node
+    {
+        T items[persistent_vector_width];
+    };
+
+    /* sizes[i] is the number of items under children 0 to i */
+    struct branch : node
+    {
+        size_t sizes[persistent_vector_width];
+        node*  children[persistent_vector_width];
+    };
+
+    typedef node   node_t;
+    typedef leaf   leaf_t;
+    typedef branch branch_t;
+
+    size_t          m_size;
+    size_t          m_tree_size;
+    size_t          m_height; /* of m_root, leaves are at height 0 */
+    node_t*         m_root;
+    leaf_t*         m_tail;
+    item_comparator m_comparator;
+
+    /* functions */
+    void take(const size_t count);
+    void drop(const size_t count);
+    void push_tail();
+    void pop_tail();
+    void collapse_root();
+
+    static bool      append_leaf(node_t*& slot, const size_t height, leaf_t* tail);
+    static node_t*   new_path(const size_t height, leaf_t* tail);
+    static leaf_t*   remove_last_leaf(node_t*& slot, const size_t height);
+    static void      take_tree(node_t*& slot, const size_t height, const size_t count);
+    static void      drop_tree(node_t*& slot, const size_t height, const size_t count);
+    static branch_t* merge(node_t* left, const size_t left_height, node_t* right, const size_t right_height);
+    static branch_t* rebalance(branch_t* left, branch_t* centre, branch_t* right, const size_t height);
+    static size_t    plan_rebalance(size_t* counts, size_t nodes);
+    static branch_t* make_branch(node_t** children, const size_t count, const size_t child_height);
+    static size_t    child_at(branch_t* parent, const size_t height, size_t& index);
+    static size_t    node_size(node_t* n, const size_t height);
+    static leaf_t*   editable_leaf(leaf_t*& slot);
+    static leaf_t*   editable_leaf(node_t*& slot);
+    static branch_t* editable_branch(node_t*& slot, const size_t height);
+    static node_t*   retain(node_t* n);
+    static void      release(node_t* n, const size_t height);
+};
+
+template <class T>
+persistent_vector<T>::persistent_vector(item_comparator comparator)
+    : m_size{ 0 }
+    , m_tree_size{ 0 }
+    , m_height{ 0 }
+    , m_root{ nullptr }
+    , m_tail{ nullptr }
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+    {
+        throw std::invalid_argument("Comparator cannot be null");
+    }
+}
+
+/* O(1), the copy shares every node with vector */
+template <class T>
+persistent_vector<T>::persistent_vector(const persistent_vector& vector)
+    : m_size{ vector.m_size }
+    , m_tree_size{ vector.m_tree_size }
+    , m_height{ vector.m_height }
+    , m_root{ vector.m_root ? retain(vector.m_root) : nullptr }
+    , m_tail{ vector.m_tail ? static_cast<leaf_t*>(retain(vector.m_tail)) : nullptr }
+    , m_comparator{ vector.m_comparator }
+{
+}
+
+template <class T>
+persistent_vector<T>& persistent_vector<T>::operator=(const persistent_vector& vector)
+{
+    persistent_vector copy(vector);
+    clear();
+
+    std::swap(m_size, copy.m_size);
+    std::swap(m_tree_size, copy.m_tree_size);
+    std::swap(m_height, copy.m_height);
+    std::swap(m_root, copy.m_root);
+    std::swap(m_tail, copy.m_tail);
+    m_comparator = copy.m_comparator;
+    return *this;
+}
+
+template <class T>
+persistent_vector<T>::~persistent_vector()
+{
+    clear();
+}
+
+template <class T>
+size_t persistent_vector<T>::size()
+{
+    return m_size;
+}
+
+template <class T>
+bool persistent_vector<T>::is_empty()
+{
+    return !m_size;
+}
+
+template <class T>
+const T& persistent_vector<T>::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    if (index >= m_tree_size)
+        return m_tail->items[index - m_tree_size];
+
+    size_t  offset = index;
+    node_t* n      = m_root;
+    for (size_t height = m_height; height; --height)
+    {
+        branch_t* parent = static_cast<branch_t*>(n);
+        n                = parent->children[child_at(parent, height, offset)];
+    }
+
+    return static_cast<leaf_t*>(n)->items[offset];
+}
+
+template <class T>
+void persistent_vector<T>::set(const size_t index, const T& item)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    if (index >= m_tree_size)
+    {
+        editable_leaf(m_tail)->items[index - m_tree_size] = item;
+        return;
+    }
+
+    size_t   offset = index;
+    node_t** slot   = &m_root;
+    for (size_t height = m_height; height; --height)
+    {
+        branch_t* parent = editable_branch(*slot, height);
+        slot             = &parent->children[child_at(parent, height, offset)];
+    }
+
+    editable_leaf(*slot)->items[offset] = item;
+}
+
+template <class T>
+void persistent_vector<T>::push(const T& item)
+{
+    if (m_tail && m_tail->count == persistent_vector_width)
+        push_tail();
+
+    if (!m_tail)
+        m_tail = new leaf_t();
+
+    leaf_t* tail = editable_leaf(m_tail);
+    tail->items[tail->count++] = item;
+    m_size++;
+}
+
+template <class T>
+T persistent_vector<T>::pop()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    leaf_t* tail = editable_leaf(m_tail);
+    T       ret  = tail->items[--tail->count];
+    m_size--;
+
+    if (!tail->count)
+    {
+        release(m_tail, 0);
+        m_tail = nullptr;
+        if (m_tree_size)
+            pop_tail();
+    }
+
+    return ret;
+}
+
+template <class T>
+void persistent_vector<T>::insert(const size_t index, const T& item)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    if (index == m_size)
+    {
+        push(item);
+        return;
+    }
+
+    persistent_vector right(*this);
+    right.drop(index);
+    take(index);
+    push(item);
+    append(right);
+}
+
+template <class T>
+void persistent_vector<T>::erase_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to delete item.");
+
+    if (index == m_size - 1)
+    {
+        pop();
+        return;
+    }
+
+    persistent_vector right(*this);
+    right.drop(index + 1);
+    take(index);
+    append(right);
+}
+
+/* Concatenates the items of vector after ours, rebalancing the seam of the two trees */
+template <class T>
+void persistent_vector<T>::append(const persistent_vector& vector)
+{
+    persistent_vector other(vector);
+    if (!other.m_size)
+        return;
+
+    if (!m_size)
+    {
+        *this = other;
+        return;
+    }
+
+    if (!other.m_tree_size)
+    {
+        for (size_t i = 0; i < other.m_tail->count; ++i)
+            push(other.m_tail->items[i]);
+        return;
+    }
+
+    push_tail();
+
+    size_t    height = std::max(m_height, other.m_height) + 1;
+    branch_t* root   = merge(m_root, m_height, other.m_root, other.m_height);
+    release(m_root, m_height);
+    m_root   = root;
+    m_height = height;
+    collapse_root();
+
+    m_tail = static_cast<leaf_t*>(retain(other.m_tail));
+    m_tree_size += other.m_tree_size;
+    m_size += other.m_size;
+}
+
+template <class T>
+void persistent_vector<T>::clear()
+{
+    if (m_root)
+        release(m_root, m_height);
+    if (m_tail)
+        release(m_tail, 0);
+
+    m_size      = 0;
+    m_tree_size = 0;
+    m_height    = 0;
+    m_root      = nullptr;
+    m_tail      = nullptr;
+}
+
+template <class T>
+int persistent_vector<T>::find(const T& item)
+{
+    for (size_t i = 0; i < m_size; ++i)
+    {
+        if (m_comparator(at(i), item))
+            return i;
+    }
+
+    return -1;
+}
+
+template <class T>
+persistent_vector<T> persistent_vector<T>::snapshot()
+{
+    return persistent_vector(*this);
+}
+
+/* Keeps the first count items */
+template <class T>
+void persistent_vector<T>::take(const size_t count)
+{
+    if (count >= m_size)
+        return;
+
+    if (!count)
+    {
+        clear();
+        return;
+    }
+
+    if (count > m_tree_size)
+    {
+        leaf_t* tail = editable_leaf(m_tail);
+        tail->count  = count - m_tree_size;
+        m_size       = count;
+        return;
+    }
+
+    release(m_tail, 0);
+    m_tail = nullptr;
+
+    take_tree(m_root, m_height, count);
+    m_tree_size = count;
+    m_size      = count;
+    collapse_root();
+    pop_tail();
+}
+
+/* Removes the first count items */
+template <class T>
+void persistent_vector<T>::drop(const size_t count)
+{
+    if (!count)
+        return;
+
+    if (count >= m_size)
+    {
+        clear();
+        return;
+    }
+
+    if (count >= m_tree_size)
+    {
+        leaf_t* tail  = editable_leaf(m_tail);
+        size_t  first = count - m_tree_size;
+        std::copy(tail->items + first, tail->items + tail->count, tail->items);
+        tail->count -= first;
+
+        if (m_root)
+            release(m_root, m_height);
+        m_root      = nullptr;
+        m_height    = 0;
+        m_tree_size = 0;
+        m_size -= count;
+        return;
+    }
+
+    drop_tree(m_root, m_height, count);
+    m_tree_size -= count;
+    m_size -= count;
+    collapse_root();
+}
+
+/* Moves the tail, full or not, into the tree as its last leaf */
+template <class T>
+void persistent_vector<T>::push_tail()
+{
+    leaf_t* tail = m_tail;
+    m_tail       = nullptr;
+    m_tree_size += tail->count;
+
+    if (!m_root)
+    {
+        m_root   = tail;
+        m_height = 0;
+        return;
+    }
+
+    if (!m_height || !append_leaf(m_root, m_height, tail))
+    {
+        node_t* children[] = { m_root, new_path(m_height, tail) };
+        m_root             = make_branch(children, 2, m_height);
+        m_height++;
+    }
+}
+
+/* Moves the last leaf of the tree out into the empty tail */
+template <class T>
+void persistent_vector<T>::pop_tail()
+{
+    if (!m_height)
+    {
+        m_tail = static_cast<leaf_t*>(m_root);
+        m_root = nullptr;
+    }
+    else
+    {
+        m_tail = remove_last_leaf(m_root, m_height);
+        collapse_root();
+    }
+
+    m_tree_size -= m_tail->count;
+}
+
+template <class T>
+void persistent_vector<T>::collapse_root()
+{
+    while (m_height && static_cast<branch_t*>(m_root)->count == 1)
+    {
+        node_t* child = retain(static_cast<branch_t*>(m_root)->children[0]);
+        release(m_root, m_height);
+        m_root = child;
+        m_height--;
+    }
+}
+
+/* Appends tail under the right spine of slot, false when every level on it is full */
+template <class T>
+bool persistent_vector<T>::append_leaf(node_t*& slot, const size_t height, leaf_t* tail)
+{
+    branch_t* parent = editable_branch(slot, height);
+    size_t    last   = parent->count - 1;
+
+    if (height > 1 && append_leaf(parent->children[last], height - 1, tail))
+    {
+        parent->sizes[last] += tail->count;
+        return true;
+    }
+
+    if (parent->count == persistent_vector_width)
+        return false;
+
+    parent->children[parent->count] = new_path(height - 1, tail);
+    parent->sizes[parent->count]    = parent->sizes[last] + tail->count;
+    parent->count++;
+    return true;
+}
+
+template <class T>
+typename persistent_vector<T>::node_t* persistent_vector<T>::new_path(const size_t height, leaf_t* tail)
+{
+    node_t* n = tail;
+    for (size_t level = 0; level < height; ++level)
+        n = make_branch(&n, 1, level);
+
+    return n;
+}
+
+template <class T>
+typename persistent_vector<T>::leaf_t* persistent_vector<T>::remove_last_leaf(node_t*& slot, const size_t height)
+{
+    branch_t* parent = editable_branch(slot, height);
+    size_t    last   = parent->count - 1;
+
+    if (height == 1)
+    {
+        parent->count--;
+        return static_cast<leaf_t*>(parent->children[last]);
+    }
+
+    leaf_t*   tail  = remove_last_leaf(parent->children[last], height - 1);
+    branch_t* child = static_cast<branch_t*>(parent->children[last]);
+    if (child->count)
+    {
+        parent->sizes[last] -= tail->count;
+    }
+    else
+    {
+        release(child, height - 1);
+        parent->count--;
+    }
+
+    return tail;
+}
+
+template <class T>
+void persistent_vector<T>::take_tree(node_t*& slot, const size_t height, const size_t count)
+{
+    if (!height)
+    {
+        editable_leaf(slot)->count = count;
+        return;
+    }
+
+    branch_t* parent = editable_branch(slot, height);
+    size_t    offset = count - 1;
+    size_t    last   = child_at(parent, height, offset);
+
+    for (size_t i = last + 1; i < parent->count; ++i)
+        release(parent->children[i], height - 1);
+
+    parent->count       = last + 1;
+    parent->sizes[last] = count;
+    take_tree(parent->children[last], height - 1, offset + 1);
+}
+
+template <class T>
+void persistent_vector<T>::drop_tree(node_t*& slot, const size_t height, const size_t count)
+{
+    if (!height)
+    {
+        leaf_t* leaf = editable_leaf(slot);
+        std::copy(leaf->items + count, leaf->items + leaf->count, leaf->items);
+        leaf->count -= count;
+        return;
+    }
+
+    branch_t* parent = editable_branch(slot, height);
+    size_t    offset = count;
+    size_t    first  = child_at(parent, height, offset);
+
+    for (size_t i = 0; i < first; ++i)
+        release(parent->children[i], height - 1);
+
+    drop_tree(parent->children[first], height - 1, offset);
+
+    for (size_t i = first; i < parent->count; ++i)
+    {
+        parent->children[i - first] = parent->children[i];
+        parent->sizes[i - first]    = parent->sizes[i] - count;
+    }
+    parent->count -= first;
+}
+
+/*
+ * Concatenates two subtrees into a new branch one level above the taller,
+ * holding one or two children. The seam is merged bottom-up and every level
+ * of it rebalanced, all other nodes are shared with the inputs.
+ */
+template <class T>
+typename persistent_vector<T>::branch_t* persistent_vector<T>::merge(node_t*      left,
+                                                                     const size_t left_height,
+                                                                     node_t*      right,
+                                                                     const size_t right_height)
+{
+    if (!left_height && !right_height)
+    {
+        node_t* children[] = { retain(left), retain(right) };
+        return make_branch(children, 2, 0);
+    }
+
+    branch_t* left_branch  = left_height >= right_height ? static_cast<branch_t*>(left) : nullptr;
+    branch_t* right_branch = right_height >= left_height ? static_cast<branch_t*>(right) : nullptr;
+    node_t*   left_seam    = left_branch ? left_branch->children[left_branch->count - 1] : left;
+    node_t*   right_seam   = right_branch ? right_branch->children[0] : right;
+
+    size_t    height = std::max(left_height, right_height);
+    branch_t* centre = merge(left_seam,
+                             left_branch ? left_height - 1 : left_height,
+                             right_seam,
+                             right_branch ? right_height - 1 : right_height);
+    branch_t* ret    = rebalance(left_branch, centre, right_branch, height);
+    release(centre, height);
+    return ret;
+}
+
+/*
+ * Redistributes the children of left but its last, of centre and of right
+ * but its first, all at height - 1, into as few nodes as the search step
+ * invariant needs and returns them under a new branch at height + 1.
+ */
+template <class T>
+typename persistent_vector<T>::branch_t* persistent_vector<T>::rebalance(branch_t*    left,
+                                                                         branch_t*    centre,
+                                                                         branch_t*    right,
+                                                                         const size_t height)
+{
+    node_t* all[2 * persistent_vector_width + 2];
+    size_t  nodes = 0;
+    if (left)
+    {
+        for (size_t i = 0; i + 1 < left->count; ++i)
+            all[nodes++] = left->children[i];
+    }
+    for (size_t i = 0; i < centre->count; ++i)
+        all[nodes++] = centre->children[i];
+    if (right)
+    {
+        for (size_t i = 1; i < right->count; ++i)
+            all[nodes++] = right->children[i];
+    }
+
+    size_t counts[2 * persistent_vector_width + 2];
+    for (size_t i = 0; i < nodes; ++i)
+        counts[i] = all[i]->count;
+    size_t planned = plan_rebalance(counts, nodes);
+
+    /* Nodes already of their planned size are shared, the others rebuilt from the stream */
+    node_t* merged[2 * persistent_vector_width + 2];
+    size_t  source = 0;
+    size_t  offset = 0;
+    for (size_t i = 0; i < planned; ++i)
+    {
+        if (!offset && all[source]->count == counts[i])
+        {
+            merged[i] = retain(all[source++]);
+            continue;
+        }
+
+        leaf_t* leaf = height == 1 ? new leaf_t() : nullptr;
+        node_t* children[persistent_vector_width];
+        size_t  filled = 0;
+        while (filled < counts[i])
+        {
+            size_t moved = std::min(counts[i] - filled, all[source]->count - offset);
+            if (leaf)
+            {
+                leaf_t* from = static_cast<leaf_t*>(all[source]);
+                std::copy(from->items + offset, from->items + offset + moved, leaf->items + filled);
+            }
+            else
+            {
+                branch_t* from = static_cast<branch_t*>(all[source]);
+                for (size_t j = 0; j < moved; ++j)
+                    children[filled + j] = retain(from->children[offset + j]);
+            }
+
+            filled += moved;
+            offset += moved;
+            if (offset == all[source]->count)
+            {
+                source++;
+                offset = 0;
+            }
+        }
+
+        if (leaf)
+        {
+            leaf->count = filled;
+            merged[i]   = leaf;
+        }
+        else
+        {
+            merged[i] = make_branch(children, filled, height - 2);
+        }
+    }
+
+    node_t* parents[2];
+    size_t  first = std::min(planned, persistent_vector_width);
+    parents[0]    = make_branch(merged, first, height - 1);
+    if (planned > first)
+        parents[1] = make_branch(merged + first, planned - first, height - 1);
+
+    return make_branch(parents, planned > first ? 2 : 1, height);
+}
+
+/*
+ * Merges runs of underfull nodes into their successors until at most
+ * persistent_vector_extra_nodes more nodes than the optimum remain. Rewrites
+ * counts with the planned node sizes and returns their number.
+ */
+template <class T>
+size_t persistent_vector<T>::plan_rebalance(size_t* counts, size_t nodes)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < nodes; ++i)
+        total += counts[i];
+
+    size_t optimal = (total + persistent_vector_width - 1) / persistent_vector_width;
+    size_t i       = 0;
+    while (nodes > optimal + persistent_vector_extra_nodes)
+    {
+        while (counts[i] > persistent_vector_width - persistent_vector_extra_nodes / 2)
+            i++;
+
+        /* Spread node i over the following ones, filling each to the width */
+        size_t remaining = counts[i];
+        do
+        {
+            size_t filled = std::min(remaining + counts[i + 1], persistent_vector_width);
+            counts[i]     = filled;
+            remaining     = remaining + counts[i + 1] - filled;
+            i++;
+        } while (remaining);
+
+        for (size_t j = i; j + 1 < nodes; ++j)
+            counts[j] = counts[j + 1];
+        nodes--;
+        i--;
+    }
+
+    return nodes;
+}
+
+/* Builds a branch owning the given references to children at child_height */
+template <class T>
+typename persistent_vector<T>::branch_t* persistent_vector<T>::make_branch(node_t**     children,
+                                                                           const size_t count,
+                                                                           const size_t child_height)
+{
+    branch_t* parent = new branch_t();
+    size_t    total  = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        total += node_size(children[i], child_height);
+        parent->children[i] = children[i];
+        parent->sizes[i]    = total;
+    }
+
+    parent->count = count;
+    return parent;
+}
+
+/*
+ * Returns the child of parent holding item index and makes index relative
+ * to it. No child holds more than 32^height items, so the radix guess is
+ * never past the right child and relaxed nodes scan forward from it.
+ */
+template <class T>
+size_t persistent_vector<T>::child_at(branch_t* parent, const size_t height, size_t& index)
+{
+    size_t child = index >> (persistent_vector_bits * height);
+    while (parent->sizes[child] <= index)
+        child++;
+
+    if (child)
+        index -= parent->sizes[child - 1];
+
+    return child;
+}
+
+template <class T>
+size_t persistent_vector<T>::node_size(node_t* n, const size_t height)
+{
+    if (!height)
+        return n->count;
+
+    return static_cast<branch_t*>(n)->sizes[n->count - 1];
+}
+
+/* Copies slot unless this vector owns it alone */
+template <class T>
+typename persistent_vector<T>::leaf_t* persistent_vector<T>::editable_leaf(leaf_t*& slot)
+{
+    if (slot->refs.load(std::memory_order_acquire) == 1)
+        return slot;
+
+    leaf_t* copy = new leaf_t();
+    std::copy(slot->items, slot->items + slot->count, copy->items);
+    copy->count = slot->count;
+
+    release(slot, 0);
+    slot = copy;
+    return copy;
+}
+
+template <class T>
+typename persistent_vector<T>::leaf_t* persistent_vector<T>::editable_leaf(node_t*& slot)
+{
+    leaf_t* leaf = static_cast<leaf_t*>(slot);
+    slot         = editable_leaf(leaf);
+    return leaf;
+}
+
+template <class T>
+typename persistent_vector<T>::branch_t* persistent_vector<T>::editable_branch(node_t*& slot, const size_t height)
+{
+    branch_t* parent = static_cast<branch_t*>(slot);
+    if (parent->refs.load(std::memory_order_acquire) == 1)
+        return parent;
+
+    branch_t* copy = new branch_t();
+    for (size_t i = 0; i < parent->count; ++i)
+    {
+        copy->children[i] = retain(parent->children[i]);
+        copy->sizes[i]    = parent->sizes[i];
+    }
+    copy->count = parent->count;
+
+    release(parent, height);
+    slot = copy;
+    return copy;
+}
+
+template <class T>
+typename persistent_vector<T>::node_t* persistent_vector<T>::retain(node_t* n)
+{
+    n->refs.fetch_add(1, std::memory_order_relaxed);
+    return n;
+}
+
+template <class T>
+void persistent_vector<T>::release(node_t* n, const size_t height)
+{
+    if (n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+
+    if (!height)
+    {
+        delete static_cast<leaf_t*>(n);
+        return;
+    }
+
+    branch_t* parent = static_cast<branch_t*>(n);
+    for (size_t i = 0; i < parent->count; ++i)
+        release(parent->children[i], height - 1);
+
+    delete parent;
+}
+
+} // namespace orla
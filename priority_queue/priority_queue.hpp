@@ -0,0 +1,397 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <stdexcept>
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const size_t cache_line_size = 64;
+
+/**
+ * cache_aligned_allocator - vector storage policy aligning the array to a cache line
+ *
+ * Items are constructed in memory from posix_memalign, so item i and item
+ * i + cache_line_size / sizeof(T) share a line whenever the first is on a
+ * line boundary.
+ */
+template <class T>
+struct cache_aligned_allocator
+{
+    static T*   allocate(const size_t capacity);
+    static void deallocate(T* array, const size_t capacity);
+    static T*   reallocate(T* array, const size_t capacity, const size_t new_capacity, const size_t size);
+};
+
+/**
+ * priority_queue - d-ary implicit heap with handles for update and erase
+ *
+ * top() is the item ordered first by Compare, so std::less<T> serves the
+ * smallest item first. The heap is stored in an orla::vector, each of its
+ * items carrying the handle push() returned for it, and a position map
+ * indexed by handle tracks where every item currently is. Sifting moves
+ * the hole, not the item, and rewrites the position of every item it moves.
+ *
+ * The root is stored at array index D - 1, so the D children of any item
+ * start at a multiple of D. With the cache aligned array and the default
+ * D = 4, the children of an item holding 8 byte keys sit on one cache line
+ * and a level of sift_down() costs one miss. push(), pop(), update() and
+ * erase() are O(log_D n); make_heap() builds from a range in O(n).
+ *
+ * A handle stays valid until its item is popped or erased, after which it
+ * may be given to a new item.
+ */
+template <class T, class Compare = std::less<T>, size_t D = 4>
+class priority_queue
+{
+    static_assert(D >= 2, "priority_queue needs at least two children per item");
+
+public:
+    typedef size_t handle;
+
+    priority_queue(const Compare& compare = Compare());
+    priority_queue(const priority_queue& queue) = delete;
+
+    size_t size();
+    bool   is_empty();
+    bool   contains(const handle item);
+
+    handle   push(const T& item);
+    const T& top();
+    handle   top_handle();
+    T        pop();
+    const T& value_of(const handle item);
+    void     update(const handle item, const T& value);
+    void     decrease_key(const handle item, const T& value);
+    void     erase(const handle item);
+    void     clear();
+
+    template <class It>
+    void make_heap(It first, It last, handle* handles = nullptr);
+
+private:
+    /* data */
+    typedef struct entry
+    {
+        T      item;
+        handle id;
+    } entry_t;
+
+    static const size_t root_offset = D - 1;
+    static const size_t no_position = SIZE_MAX;
+
+    vector<entry_t, cache_aligned_allocator<entry_t>, null_stats, unchecked_bounds> m_heap;
+    vector<size_t, default_allocator<size_t>, null_stats, unchecked_bounds>         m_positions;
+    vector<size_t, default_allocator<size_t>, null_stats, unchecked_bounds>         m_free_handles;
+    Compare                                                                          m_compare;
+
+    /* functions */
+    entry_t&    entry_at(const size_t index);
+    void        place(const size_t index, const entry_t& entry);
+    void        sift_up(size_t index, const entry_t& entry);
+    void        sift_down(size_t index, const entry_t& entry);
+    void        sift(const size_t index, const entry_t& entry);
+    void        check_handle(const handle item);
+    void        release_handle(const handle item);
+    handle      new_handle();
+    static bool entry_comparator(const entry_t& a, const entry_t& b);
+    static bool index_comparator(const size_t& a, const size_t& b);
+};
+
+template <class T>
+T* cache_aligned_allocator<T>::allocate(const size_t capacity)
+{
+    void* memory = nullptr;
+    if (posix_memalign(&memory, cache_line_size, capacity * sizeof(T)))
+        throw std::bad_alloc();
+
+    T* array = static_cast<T*>(memory);
+    for (size_t i = 0; i < capacity; ++i)
+        new (array + i) T();
+
+    return array;
+}
+
+template <class T>
+void cache_aligned_allocator<T>::deallocate(T* array, const size_t capacity)
+{
+    for (size_t i = 0; i < capacity; ++i)
+        (array + i)->~T();
+
+    free(array);
+}
+
+template <class T>
+T* cache_aligned_allocator<T>::reallocate(T* array, const size_t capacity, const size_t new_capacity, const size_t size)
+{
+    T* temp_array = allocate(new_capacity);
+    for (size_t i = 0; i < size; ++i)
+        *(temp_array + i) = *(array + i);
+
+    deallocate(array, capacity);
+    return temp_array;
+}
+
+template <class T, class Compare, size_t D>
+const size_t priority_queue<T, Compare, D>::root_offset;
+
+template <class T, class Compare, size_t D>
+const size_t priority_queue<T, Compare, D>::no_position;
+
+template <class T, class Compare, size_t D>
+priority_queue<T, Compare, D>::priority_queue(const Compare& compare)
+    : m_heap{ entry_comparator }
+    , m_positions{ index_comparator }
+    , m_free_handles{ index_comparator }
+    , m_compare(compare)
+{
+    /* Padding in front of the root, never compared nor moved */
+    for (size_t i = 0; i < root_offset; ++i)
+        m_heap.push(entry_t{ T(), no_position });
+}
+
+template <class T, class Compare, size_t D>
+size_t priority_queue<T, Compare, D>::size()
+{
+    return m_heap.size() - root_offset;
+}
+
+template <class T, class Compare, size_t D>
+bool priority_queue<T, Compare, D>::is_empty()
+{
+    return !size();
+}
+
+template <class T, class Compare, size_t D>
+bool priority_queue<T, Compare, D>::contains(const handle item)
+{
+    return item < m_positions.size() && m_positions[item] != no_position;
+}
+
+template <class T, class Compare, size_t D>
+typename priority_queue<T, Compare, D>::handle priority_queue<T, Compare, D>::push(const T& item)
+{
+    handle id = new_handle();
+    m_heap.push(entry_t{ item, id });
+    sift_up(size() - 1, entry_t{ item, id });
+    return id;
+}
+
+template <class T, class Compare, size_t D>
+const T& priority_queue<T, Compare, D>::top()
+{
+    if (is_empty())
+        throw std::logic_error("Cannot get top item from an empty priority queue");
+
+    return entry_at(0).item;
+}
+
+template <class T, class Compare, size_t D>
+typename priority_queue<T, Compare, D>::handle priority_queue<T, Compare, D>::top_handle()
+{
+    if (is_empty())
+        throw std::logic_error("Cannot get top item from an empty priority queue");
+
+    return entry_at(0).id;
+}
+
+template <class T, class Compare, size_t D>
+T priority_queue<T, Compare, D>::pop()
+{
+    if (is_empty())
+        throw std::logic_error("Cannot pop from an empty priority queue");
+
+    T ret = entry_at(0).item;
+    release_handle(entry_at(0).id);
+
+    entry_t last = m_heap.pop_unchecked();
+    if (!is_empty())
+        sift_down(0, last);
+
+    return ret;
+}
+
+template <class T, class Compare, size_t D>
+const T& priority_queue<T, Compare, D>::value_of(const handle item)
+{
+    check_handle(item);
+
+    return entry_at(m_positions[item]).item;
+}
+
+/* Replaces the value of item and moves it up or down to its new place */
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::update(const handle item, const T& value)
+{
+    check_handle(item);
+
+    sift(m_positions[item], entry_t{ value, item });
+}
+
+/* Like update() for a value ordered no later than the current one, which only moves up */
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::decrease_key(const handle item, const T& value)
+{
+    check_handle(item);
+
+    size_t index = m_positions[item];
+    if (m_compare(entry_at(index).item, value))
+        throw std::invalid_argument("New key is ordered after the current one");
+
+    sift_up(index, entry_t{ value, item });
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::erase(const handle item)
+{
+    check_handle(item);
+
+    size_t index = m_positions[item];
+    release_handle(item);
+
+    entry_t last = m_heap.pop_unchecked();
+    if (index < size())
+        sift(index, last);
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::clear()
+{
+    while (!is_empty())
+        release_handle(m_heap.pop_unchecked().id);
+}
+
+/*
+ * Replaces the contents with the items of [first, last) and heapifies them
+ * bottom-up. When handles is not null, handles[i] receives the handle of
+ * the i-th item.
+ */
+template <class T, class Compare, size_t D>
+template <class It>
+void priority_queue<T, Compare, D>::make_heap(It first, It last, handle* handles)
+{
+    clear();
+
+    for (size_t i = 0; first != last; ++first, ++i)
+    {
+        handle id = new_handle();
+        m_heap.push(entry_t{ *first, id });
+        m_positions[id] = i;
+        if (handles)
+            handles[i] = id;
+    }
+
+    if (size() < 2)
+        return;
+
+    for (size_t index = (size() - 2) / D + 1; index--;)
+        sift_down(index, entry_at(index));
+}
+
+template <class T, class Compare, size_t D>
+typename priority_queue<T, Compare, D>::entry_t& priority_queue<T, Compare, D>::entry_at(const size_t index)
+{
+    return m_heap[index + root_offset];
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::place(const size_t index, const entry_t& entry)
+{
+    entry_at(index)       = entry;
+    m_positions[entry.id] = index;
+}
+
+/* Moves the hole at index towards the root until entry fits in it */
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::sift_up(size_t index, const entry_t& entry)
+{
+    while (index)
+    {
+        size_t parent = (index - 1) / D;
+        if (!m_compare(entry.item, entry_at(parent).item))
+            break;
+
+        place(index, entry_at(parent));
+        index = parent;
+    }
+
+    place(index, entry);
+}
+
+/* Moves the hole at index towards the leaves until entry fits in it */
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::sift_down(size_t index, const entry_t& entry)
+{
+    entry_t moving = entry;
+    size_t  count  = size();
+    for (size_t first = index * D + 1; first < count; first = index * D + 1)
+    {
+        size_t last = first + D < count ? first + D : count;
+        size_t best = first;
+        for (size_t child = first + 1; child < last; ++child)
+        {
+            if (m_compare(entry_at(child).item, entry_at(best).item))
+                best = child;
+        }
+
+        if (!m_compare(entry_at(best).item, moving.item))
+            break;
+
+        place(index, entry_at(best));
+        index = best;
+    }
+
+    place(index, moving);
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::sift(const size_t index, const entry_t& entry)
+{
+    if (index && m_compare(entry.item, entry_at((index - 1) / D).item))
+        sift_up(index, entry);
+    else
+        sift_down(index, entry);
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::check_handle(const handle item)
+{
+    if (!contains(item))
+        throw std::invalid_argument("Invalid priority queue handle");
+}
+
+template <class T, class Compare, size_t D>
+void priority_queue<T, Compare, D>::release_handle(const handle item)
+{
+    m_positions[item] = no_position;
+    m_free_handles.push(item);
+}
+
+template <class T, class Compare, size_t D>
+typename priority_queue<T, Compare, D>::handle priority_queue<T, Compare, D>::new_handle()
+{
+    if (!m_free_handles.is_empty())
+        return m_free_handles.pop_unchecked();
+
+    m_positions.push(no_position);
+    return m_positions.size() - 1;
+}
+
+template <class T, class Compare, size_t D>
+bool priority_queue<T, Compare, D>::entry_comparator(const entry_t& a, const entry_t& b)
+{
+    return a.id == b.id;
+}
+
+template <class T, class Compare, size_t D>
+bool priority_queue<T, Compare, D>::index_comparator(const size_t& a, const size_t& b)
+{
+    return a == b;
+}
+
+} // namespace orla
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <stddef.h>
+#include <utility>
+#include "bounds.hpp"
+#include "stats.hpp"
 
 namespace orla
 {
@@ -19,11 +25,12 @@ namespace orla
         (type*)((char*)__mptr - offsetof(type, member));  \
     })
 
-template <class T>
-class singly_linked_list
+template <class T, class Stats = null_stats, class Bounds = checked_bounds>
+class singly_linked_list : private Stats
 {
 public:
     typedef bool (*item_comparator)(const T& a, const T& b);
+    class iterator;
 
     singly_linked_list(item_comparator comparator);
     singly_linked_list(const singly_linked_list& list) = delete;
@@ -38,11 +45,28 @@ public:
     T      pop_back();
     T&     front();
     T&     back();
+    T&     front_unchecked() noexcept;
+    T&     back_unchecked() noexcept;
+    T      pop_front_unchecked();
+    T      pop_back_unchecked();
     void   insert(const size_t index, const T& value);
     void   erase(const size_t index);
     T&     value_n_from_end(const size_t n);
     void   reverse();
     void   remove_value(const T& value);
+    void   truncate(const size_t new_size);
+    void   value_at_many(const size_t* indices, const size_t count, T** values);
+    size_t erase_many(const size_t* indices, const size_t count);
+
+    access_error try_value_at(const size_t index, T** value) noexcept;
+    access_error try_pop_front(T* value);
+    access_error try_pop_back(T* value);
+
+    iterator begin();
+    iterator end();
+
+    using Stats::stats;
+    using Stats::reset_stats;
 
 private:
     /* data */
@@ -58,11 +82,67 @@ private:
     item_comparator m_comparator;
 
     /* functions */
-    void remove_next_node(node_t** node);
+    node_t* node_at(const size_t index);
+    void    remove_next_node(node_t** node);
+    void    check_indices(const size_t* indices, const size_t count);
 };
 
-template <class T>
-singly_linked_list<T>::singly_linked_list(item_comparator comparator)
+template <class T, class Stats, class Bounds>
+class singly_linked_list<T, Stats, Bounds>::iterator
+{
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef T                         value_type;
+    typedef ptrdiff_t                 difference_type;
+    typedef T*                        pointer;
+    typedef T&                        reference;
+
+    iterator()
+        : m_node{ nullptr }
+    {
+    }
+
+    T& operator*() const
+    {
+        return m_node->item;
+    }
+    T* operator->() const
+    {
+        return &m_node->item;
+    }
+    iterator& operator++()
+    {
+        m_node = m_node->next;
+        return *this;
+    }
+    iterator operator++(int)
+    {
+        iterator ret = *this;
+        m_node       = m_node->next;
+        return ret;
+    }
+    bool operator==(const iterator& other) const
+    {
+        return m_node == other.m_node;
+    }
+    bool operator!=(const iterator& other) const
+    {
+        return m_node != other.m_node;
+    }
+
+private:
+    friend class singly_linked_list<T, Stats, Bounds>;
+
+    explicit iterator(node_t* node)
+        : m_node{ node }
+    {
+    }
+
+    node_t* m_node;
+};
+
+template <class T, class Stats, class Bounds>
+singly_linked_list<T, Stats, Bounds>::singly_linked_list(item_comparator comparator)
     : m_size{ 0 }
     , m_head{ nullptr }
     , m_tail{ nullptr }
@@ -74,8 +154,8 @@ singly_linked_list<T>::singly_linked_list(item_comparator comparator)
     }
 }
 
-template <class T>
-singly_linked_list<T>::~singly_linked_list()
+template <class T, class Stats, class Bounds>
+singly_linked_list<T, Stats, Bounds>::~singly_linked_list()
 {
     node_t* del;
     while (m_head)
@@ -86,54 +166,55 @@ singly_linked_list<T>::~singly_linked_list()
     }
 }
 
-template <class T>
-size_t singly_linked_list<T>::size()
+template <class T, class Stats, class Bounds>
+size_t singly_linked_list<T, Stats, Bounds>::size()
 {
     return m_size;
 }
 
-template <class T>
-bool singly_linked_list<T>::is_empty()
+template <class T, class Stats, class Bounds>
+bool singly_linked_list<T, Stats, Bounds>::is_empty()
 {
     return !m_size;
 }
 
-template <class T>
-T& singly_linked_list<T>::value_at(const size_t index)
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::value_at(const size_t index)
 {
-    if (index >= m_size)
-        throw std::out_of_range("Out of range index");
+    Bounds::check_index(index < m_size, "Out of range index");
 
-    node_t* tmp = m_head;
-    for (size_t i = 1; i <= index; i++)
-        tmp = tmp->next;
-
-    return tmp->item;
+    return node_at(index)->item;
 }
 
-template <class T>
-void singly_linked_list<T>::push_front(const T& value)
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::push_front(const T& value)
 {
     insert(0, value);
 }
 
-template <class T>
-T singly_linked_list<T>::pop_front()
+template <class T, class Stats, class Bounds>
+T singly_linked_list<T, Stats, Bounds>::pop_front()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot pop from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty list");
+
+    return pop_front_unchecked();
+}
 
+template <class T, class Stats, class Bounds>
+T singly_linked_list<T, Stats, Bounds>::pop_front_unchecked()
+{
     T ret = m_head->item;
     remove_next_node(&m_head);
     return ret;
 }
 
-template <class T>
-void singly_linked_list<T>::push_back(const T& value)
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::push_back(const T& value)
 {
     node_t* n = new node_t;
     n->next   = nullptr;
     n->item   = value;
+    this->count_allocation(sizeof(node_t));
 
     if (m_tail)
         m_tail->next = n;
@@ -144,15 +225,21 @@ void singly_linked_list<T>::push_back(const T& value)
     m_size++;
 }
 
-template <class T>
-T singly_linked_list<T>::pop_back()
+template <class T, class Stats, class Bounds>
+T singly_linked_list<T, Stats, Bounds>::pop_back()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot pop from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty list");
+
+    return pop_back_unchecked();
+}
 
+template <class T, class Stats, class Bounds>
+T singly_linked_list<T, Stats, Bounds>::pop_back_unchecked()
+{
     node_t** node = &m_head;
     while ((*node)->next != nullptr)
         node = &(*node)->next;
+    this->count_hops(m_size - 1);
 
     T ret = (*node)->item;
 
@@ -169,29 +256,38 @@ T singly_linked_list<T>::pop_back()
     return ret;
 }
 
-template <class T>
-T& singly_linked_list<T>::front()
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::front()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot get front item from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot get front item from an empty list");
 
     return m_head->item;
 }
 
-template <class T>
-T& singly_linked_list<T>::back()
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::back()
 {
-    if (!m_size)
-        throw std::logic_error("Cannot get last item from an empty list");
+    Bounds::check_not_empty(m_size, "Cannot get last item from an empty list");
 
     return m_tail->item;
 }
 
-template <class T>
-void singly_linked_list<T>::insert(const size_t index, const T& value)
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::front_unchecked() noexcept
 {
-    if (index > m_size)
-        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+    return m_head->item;
+}
+
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::back_unchecked() noexcept
+{
+    return m_tail->item;
+}
+
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::insert(const size_t index, const T& value)
+{
+    Bounds::check_index(index <= m_size, "Out of range index to insert item. Index should be <= size()");
 
     if (m_size && index == m_size)
     {
@@ -201,10 +297,12 @@ void singly_linked_list<T>::insert(const size_t index, const T& value)
 
     node_t* new_node = new node_t;
     new_node->item   = value;
+    this->count_allocation(sizeof(node_t));
 
     node_t** current_next_node = &m_head;
     for (size_t i = 0; i < index; ++i)
         current_next_node = &(*current_next_node)->next;
+    this->count_hops(index);
 
     new_node->next = *current_next_node;
 
@@ -216,21 +314,21 @@ void singly_linked_list<T>::insert(const size_t index, const T& value)
     m_size++;
 }
 
-template <class T>
-T& singly_linked_list<T>::value_n_from_end(const size_t n)
+template <class T, class Stats, class Bounds>
+T& singly_linked_list<T, Stats, Bounds>::value_n_from_end(const size_t n)
 {
-    if (n >= m_size)
-        throw std::out_of_range("Out of range index to get value from end");
+    Bounds::check_index(n < m_size, "Out of range index to get value from end");
 
     node_t* current_node = m_head;
     for (size_t index_from_head = m_size - 1 - n; index_from_head; --index_from_head)
         current_node = current_node->next;
+    this->count_hops(m_size - 1 - n);
 
     return current_node->item;
 }
 
-template <class T>
-void singly_linked_list<T>::reverse()
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::reverse()
 {
     if (!m_size || m_size == 1)
         return;
@@ -248,46 +346,189 @@ void singly_linked_list<T>::reverse()
     current_node = m_head;
     m_head       = m_tail;
     m_tail       = current_node;
+
+    this->count_hops(m_size);
 }
 
-template <class T>
-void singly_linked_list<T>::remove_value(const T& value)
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::remove_value(const T& value)
 {
     if (!m_size)
         return;
 
     node_t** node;
+    size_t   visited = 0;
     for (node = &m_head; *node != nullptr; node = &(*node)->next)
     {
+        visited++;
         if (m_comparator(value, (*node)->item))
         {
             remove_next_node(node);
             break;
         }
     }
+
+    this->count_hops(visited);
+    this->count_comparisons(visited);
 }
 
-template <class T>
-void singly_linked_list<T>::erase(const size_t index)
+/* Drops the items from new_size on in one walk to the new last node */
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::truncate(const size_t new_size)
 {
-    if (index >= m_size)
-        throw std::out_of_range("Out of range index to erase");
+    Bounds::check_index(new_size <= m_size, "Out of range size to truncate to");
+
+    node_t** node = &m_head;
+    for (size_t i = 0; i < new_size; ++i)
+        node = &(*node)->next;
+    this->count_hops(new_size);
+
+    while (*node)
+        remove_next_node(node);
+}
+
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::erase(const size_t index)
+{
+    Bounds::check_index(index < m_size, "Out of range index to erase");
 
     if (index == m_size - 1)
     {
-        pop_back();
+        pop_back_unchecked();
         return;
     }
 
     node_t** node = &m_head;
     for (size_t i = 0; i < index; ++i)
         node = &(*node)->next;
+    this->count_hops(index);
 
     remove_next_node(node);
 }
 
-template <class T>
-void singly_linked_list<T>::remove_next_node(node_t** node)
+/*
+ * Stores in values[i] a pointer to the item at indices[i]. The requests are
+ * sorted and answered in a single pass from the head.
+ */
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::value_at_many(const size_t* indices, const size_t count, T** values)
+{
+    check_indices(indices, count);
+
+    std::unique_ptr<std::pair<size_t, size_t>[]> order(new std::pair<size_t, size_t>[count]);
+    for (size_t i = 0; i < count; ++i)
+        order[i] = std::make_pair(indices[i], i);
+    std::sort(order.get(), order.get() + count);
+
+    node_t* current_node = m_head;
+    size_t  position     = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (; position < order[i].first; ++position)
+            current_node = current_node->next;
+
+        values[order[i].second] = &current_node->item;
+    }
+
+    this->count_hops(position);
+}
+
+/*
+ * Erases the items at the given indices, all of them referring to positions
+ * before any erasure. Duplicates are erased once. Returns the number of
+ * erased items.
+ */
+template <class T, class Stats, class Bounds>
+size_t singly_linked_list<T, Stats, Bounds>::erase_many(const size_t* indices, const size_t count)
+{
+    check_indices(indices, count);
+
+    std::unique_ptr<size_t[]> sorted(new size_t[count]);
+    std::copy(indices, indices + count, sorted.get());
+    std::sort(sorted.get(), sorted.get() + count);
+    size_t unique = std::unique(sorted.get(), sorted.get() + count) - sorted.get();
+
+    node_t** node     = &m_head;
+    size_t   position = 0;
+    for (size_t i = 0; i < unique; ++i)
+    {
+        for (; position < sorted[i]; ++position)
+            node = &(*node)->next;
+
+        remove_next_node(node);
+        position++;
+    }
+
+    this->count_hops(position - unique);
+    return unique;
+}
+
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::check_indices(const size_t* indices, const size_t count)
+{
+    if (count && !indices)
+        throw std::invalid_argument("Null index array");
+
+    for (size_t i = 0; i < count; ++i)
+        Bounds::check_index(indices[i] < m_size, "Out of range index");
+}
+
+/* Points value at the item at index, or returns out_of_range and leaves it untouched */
+template <class T, class Stats, class Bounds>
+access_error singly_linked_list<T, Stats, Bounds>::try_value_at(const size_t index, T** value) noexcept
+{
+    if (index >= m_size)
+        return access_error::out_of_range;
+
+    *value = &node_at(index)->item;
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+access_error singly_linked_list<T, Stats, Bounds>::try_pop_front(T* value)
+{
+    if (!m_size)
+        return access_error::empty;
+
+    *value = pop_front_unchecked();
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+access_error singly_linked_list<T, Stats, Bounds>::try_pop_back(T* value)
+{
+    if (!m_size)
+        return access_error::empty;
+
+    *value = pop_back_unchecked();
+    return access_error::none;
+}
+
+template <class T, class Stats, class Bounds>
+typename singly_linked_list<T, Stats, Bounds>::iterator singly_linked_list<T, Stats, Bounds>::begin()
+{
+    return iterator(m_head);
+}
+
+template <class T, class Stats, class Bounds>
+typename singly_linked_list<T, Stats, Bounds>::iterator singly_linked_list<T, Stats, Bounds>::end()
+{
+    return iterator(nullptr);
+}
+
+template <class T, class Stats, class Bounds>
+typename singly_linked_list<T, Stats, Bounds>::node_t* singly_linked_list<T, Stats, Bounds>::node_at(const size_t index)
+{
+    node_t* tmp = m_head;
+    for (size_t i = 1; i <= index; i++)
+        tmp = tmp->next;
+
+    this->count_hops(index);
+    return tmp;
+}
+
+template <class T, class Stats, class Bounds>
+void singly_linked_list<T, Stats, Bounds>::remove_next_node(node_t** node)
 {
     node_t* to_destroy = *node;
 
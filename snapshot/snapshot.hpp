@@ -0,0 +1,556 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "doubly_linked_list.hpp"
+#include "singly_linked_list.hpp"
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const uint64_t snapshot_magic        = 0x314e53414c524fULL; /* "ORLASN1" */
+static const uint32_t snapshot_version      = 1;
+static const size_t   snapshot_header_size  = 64;
+static const size_t   snapshot_trailer_size = sizeof(uint64_t);
+static const size_t   snapshot_chunk_items  = 4096;
+
+/**
+ * Snapshot format, native endianness
+ *
+ *     snapshot_header   magic, version, item size and item count, 64 bytes
+ *     payload           count items of item_size bytes, back to back
+ *     checksum          snapshot_checksum of the payload, 8 bytes
+ *
+ * The checksum trails the payload so lists can be streamed into pipes and
+ * sockets without a second pass. Only trivially copyable items can be
+ * snapshotted since the payload is their raw bytes.
+ */
+struct snapshot_header
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t item_size;
+    uint64_t count;
+    uint8_t  reserved[40];
+};
+
+static_assert(sizeof(snapshot_header) == snapshot_header_size, "snapshot_header must be 64 bytes");
+
+/* Fletcher style sum over 64-bit words, a partial last word is zero padded */
+class snapshot_checksum
+{
+public:
+    snapshot_checksum();
+
+    void     update(const void* data, size_t bytes);
+    uint64_t value();
+
+private:
+    /* data */
+    uint64_t      m_sum;
+    uint64_t      m_mix;
+    unsigned char m_pending[sizeof(uint64_t)];
+    size_t        m_pending_bytes;
+
+    /* functions */
+    void add_word(const uint64_t word);
+};
+
+/**
+ * snapshot_view - read-only zero-copy view of a vector snapshot file
+ *
+ * The file is mapped as is and at() reads items straight from the page
+ * cache. Opening only checks the header and the file size; verify() reads
+ * the whole payload to check the checksum.
+ */
+template <class T>
+class snapshot_view
+{
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be trivially copyable");
+
+public:
+    snapshot_view(const char* path);
+    snapshot_view(const snapshot_view& view) = delete;
+    ~snapshot_view();
+
+    size_t size();
+    bool   is_empty();
+    bool   verify();
+
+    const T& at(const size_t index);
+    const T* data();
+    const T* begin();
+    const T* end();
+
+private:
+    /* data */
+    void*                  m_mapping;
+    size_t                 m_mapped_bytes;
+    const snapshot_header* m_header;
+    const T*               m_array;
+};
+
+namespace detail
+{
+
+inline void throw_snapshot_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/* Moves all iov bytes with as few readv/writev calls as the kernel allows */
+inline void transfer_snapshot(int fd, iovec* iov, int count, bool writing)
+{
+    while (count)
+    {
+        ssize_t done = writing ? writev(fd, iov, count) : readv(fd, iov, count);
+        if (done < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw_snapshot_errno(writing ? "Cannot write snapshot" : "Cannot read snapshot");
+        }
+        if (!done)
+            throw std::runtime_error("Truncated snapshot");
+
+        size_t left = done;
+        while (count && left >= iov->iov_len)
+        {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count)
+        {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+inline void write_snapshot_bytes(int fd, const void* data, const size_t bytes)
+{
+    iovec iov = { const_cast<void*>(data), bytes };
+    transfer_snapshot(fd, &iov, 1, true);
+}
+
+inline void read_snapshot_bytes(int fd, void* data, const size_t bytes)
+{
+    iovec iov = { data, bytes };
+    transfer_snapshot(fd, &iov, 1, false);
+}
+
+template <class T>
+snapshot_header make_snapshot_header(const size_t count)
+{
+    snapshot_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic     = snapshot_magic;
+    header.version   = snapshot_version;
+    header.item_size = sizeof(T);
+    header.count     = count;
+    return header;
+}
+
+template <class T>
+void validate_snapshot_header(const snapshot_header& header)
+{
+    if (header.magic != snapshot_magic)
+        throw std::runtime_error("Not an orla snapshot");
+    if (header.version != snapshot_version)
+        throw std::runtime_error("Unsupported snapshot version");
+    if (header.item_size != sizeof(T))
+        throw std::runtime_error("Snapshot item size does not match");
+}
+
+template <class T>
+snapshot_header read_snapshot_header(int fd)
+{
+    snapshot_header header;
+    read_snapshot_bytes(fd, &header, sizeof(header));
+    validate_snapshot_header<T>(header);
+    return header;
+}
+
+/*
+ * Rejects counts whose payload size overflows, and on regular files counts
+ * larger than the bytes left after the header. Returns whether the count
+ * was checked against the file, so pipes and sockets are never trusted
+ * with an allocation up front.
+ */
+template <class T>
+bool check_snapshot_count(int fd, const snapshot_header& header)
+{
+    if (header.count > SIZE_MAX / sizeof(T))
+        throw std::runtime_error("Snapshot item count overflows");
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode))
+        return false;
+
+    off_t position = lseek(fd, 0, SEEK_CUR);
+    if (position < 0)
+        return false;
+
+    size_t left = st.st_size > position ? st.st_size - position : 0;
+    if (left < snapshot_trailer_size || header.count > (left - snapshot_trailer_size) / sizeof(T))
+        throw std::runtime_error("Snapshot item count exceeds the file size");
+
+    return true;
+}
+
+/* Lists that can preallocate their nodes get them in one batch */
+template <class List>
+auto reserve_list_nodes(List& list, const size_t count, int) -> decltype(list.reserve(count), void())
+{
+    list.reserve(count);
+}
+
+template <class List>
+void reserve_list_nodes(List&, const size_t, long)
+{
+}
+
+/* Streams the items of a list in chunks of chunk_items through one buffer */
+template <class T, class List>
+void write_list_snapshot(int fd, List& list, const size_t chunk_items)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be trivially copyable");
+
+    if (!chunk_items)
+        throw std::invalid_argument("Chunk size cannot be zero");
+
+    snapshot_header header = make_snapshot_header<T>(list.size());
+    write_snapshot_bytes(fd, &header, sizeof(header));
+
+    std::unique_ptr<T[]> chunk(new T[chunk_items]);
+    snapshot_checksum    checksum;
+    size_t               buffered = 0;
+    for (auto it = list.begin(); it != list.end(); ++it)
+    {
+        chunk[buffered++] = *it;
+        if (buffered == chunk_items)
+        {
+            checksum.update(chunk.get(), buffered * sizeof(T));
+            write_snapshot_bytes(fd, chunk.get(), buffered * sizeof(T));
+            buffered = 0;
+        }
+    }
+
+    checksum.update(chunk.get(), buffered * sizeof(T));
+    uint64_t sum     = checksum.value();
+    iovec    tail[2] = { { chunk.get(), buffered * sizeof(T) }, { &sum, sizeof(sum) } };
+    transfer_snapshot(fd, tail, 2, true);
+}
+
+template <class T, class List>
+void read_list_snapshot(int fd, List& list, const size_t chunk_items)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be trivially copyable");
+
+    if (!chunk_items)
+        throw std::invalid_argument("Chunk size cannot be zero");
+
+    snapshot_header header = read_snapshot_header<T>(fd);
+    if (check_snapshot_count<T>(fd, header))
+        reserve_list_nodes(list, header.count, 0);
+
+    /* A truncated or corrupt snapshot leaves the list as it was */
+    size_t old_size = list.size();
+    try
+    {
+        std::unique_ptr<T[]> chunk(new T[chunk_items]);
+        snapshot_checksum    checksum;
+        for (uint64_t left = header.count; left;)
+        {
+            size_t items = left < chunk_items ? left : chunk_items;
+            read_snapshot_bytes(fd, chunk.get(), items * sizeof(T));
+            checksum.update(chunk.get(), items * sizeof(T));
+
+            for (size_t i = 0; i < items; ++i)
+                list.push_back(chunk[i]);
+            left -= items;
+        }
+
+        uint64_t sum;
+        read_snapshot_bytes(fd, &sum, sizeof(sum));
+        if (sum != checksum.value())
+            throw std::runtime_error("Snapshot checksum mismatch");
+    }
+    catch (...)
+    {
+        list.truncate(old_size);
+        throw;
+    }
+}
+
+} // namespace detail
+
+/* Writes a vector snapshot with a single writev when the kernel allows it */
+template <class T, class A, class S, class C>
+void write_snapshot(int fd, vector<T, A, S, C>& vec)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be trivially copyable");
+
+    snapshot_header   header = detail::make_snapshot_header<T>(vec.size());
+    snapshot_checksum checksum;
+    checksum.update(vec.data(), vec.size() * sizeof(T));
+    uint64_t sum = checksum.value();
+
+    iovec iov[3] = { { &header, sizeof(header) }, { vec.data(), vec.size() * sizeof(T) }, { &sum, sizeof(sum) } };
+    detail::transfer_snapshot(fd, iov, 3, true);
+}
+
+/*
+ * Appends the items of a vector snapshot. From a regular file the payload
+ * is read straight into the vector storage together with the checksum;
+ * other streams grow the vector chunk by chunk as the items arrive. On
+ * failure the vector is truncated back to its old size.
+ */
+template <class T, class A, class S, class C>
+void read_snapshot(int fd, vector<T, A, S, C>& vec)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "snapshot items must be trivially copyable");
+
+    snapshot_header   header   = detail::read_snapshot_header<T>(fd);
+    bool              sized    = detail::check_snapshot_count<T>(fd, header);
+    size_t            old_size = vec.size();
+    snapshot_checksum checksum;
+    uint64_t          sum;
+    try
+    {
+        if (sized)
+        {
+            T*    first  = vec.extend(header.count);
+            iovec iov[2] = { { first, header.count * sizeof(T) }, { &sum, sizeof(sum) } };
+            detail::transfer_snapshot(fd, iov, 2, false);
+            checksum.update(first, header.count * sizeof(T));
+        }
+        else
+        {
+            for (uint64_t left = header.count; left;)
+            {
+                size_t items = left < snapshot_chunk_items ? left : snapshot_chunk_items;
+                T*     chunk = vec.extend(items);
+                detail::read_snapshot_bytes(fd, chunk, items * sizeof(T));
+                checksum.update(chunk, items * sizeof(T));
+                left -= items;
+            }
+            detail::read_snapshot_bytes(fd, &sum, sizeof(sum));
+        }
+
+        if (sum != checksum.value())
+            throw std::runtime_error("Snapshot checksum mismatch");
+    }
+    catch (...)
+    {
+        vec.truncate(old_size);
+        throw;
+    }
+}
+
+/* Lists are streamed in chunks of chunk_items through one buffer */
+template <class T, class S, class C>
+void write_snapshot(int fd, singly_linked_list<T, S, C>& list, const size_t chunk_items = snapshot_chunk_items)
+{
+    detail::write_list_snapshot<T>(fd, list, chunk_items);
+}
+
+template <class T, class S, class C>
+void write_snapshot(int fd, doubly_linked_list<T, S, C>& list, const size_t chunk_items = snapshot_chunk_items)
+{
+    detail::write_list_snapshot<T>(fd, list, chunk_items);
+}
+
+/* Appends the snapshot items with push_back(), chunk by chunk */
+template <class T, class S, class C>
+void read_snapshot(int fd, singly_linked_list<T, S, C>& list, const size_t chunk_items = snapshot_chunk_items)
+{
+    detail::read_list_snapshot<T>(fd, list, chunk_items);
+}
+
+/* Reserves one slab for all nodes first, so the loaded list is laid out in order */
+template <class T, class S, class C>
+void read_snapshot(int fd, doubly_linked_list<T, S, C>& list, const size_t chunk_items = snapshot_chunk_items)
+{
+    detail::read_list_snapshot<T>(fd, list, chunk_items);
+}
+
+inline snapshot_checksum::snapshot_checksum()
+    : m_sum{ 0 }
+    , m_mix{ 0 }
+    , m_pending{}
+    , m_pending_bytes{ 0 }
+{
+}
+
+inline void snapshot_checksum::update(const void* data, size_t bytes)
+{
+    const unsigned char* bytes_in = static_cast<const unsigned char*>(data);
+
+    while (m_pending_bytes && bytes)
+    {
+        m_pending[m_pending_bytes++] = *bytes_in++;
+        bytes--;
+        if (m_pending_bytes == sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, m_pending, sizeof(word));
+            add_word(word);
+            m_pending_bytes = 0;
+        }
+    }
+
+    for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t), bytes_in += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, bytes_in, sizeof(word));
+        add_word(word);
+    }
+
+    memcpy(m_pending, bytes_in, bytes);
+    m_pending_bytes = bytes;
+}
+
+inline uint64_t snapshot_checksum::value()
+{
+    uint64_t sum = m_sum;
+    uint64_t mix = m_mix;
+    if (m_pending_bytes)
+    {
+        uint64_t word = 0;
+        memcpy(&word, m_pending, m_pending_bytes);
+        sum += word;
+        mix += sum;
+    }
+
+    return mix ^ (sum * 0x9e3779b97f4a7c15ULL);
+}
+
+inline void snapshot_checksum::add_word(const uint64_t word)
+{
+    m_sum += word;
+    m_mix += m_sum;
+}
+
+template <class T>
+snapshot_view<T>::snapshot_view(const char* path)
+    : m_mapping{ nullptr }
+    , m_mapped_bytes{ 0 }
+    , m_header{ nullptr }
+    , m_array{ nullptr }
+{
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        detail::throw_snapshot_errno("Cannot open snapshot file");
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        ::close(fd);
+        detail::throw_snapshot_errno("Cannot stat snapshot file");
+    }
+
+    if (static_cast<size_t>(st.st_size) < snapshot_header_size + snapshot_trailer_size)
+    {
+        ::close(fd);
+        throw std::runtime_error("File too small to be a snapshot");
+    }
+
+    m_mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        detail::throw_snapshot_errno("Cannot map snapshot file");
+    }
+
+    m_mapped_bytes = st.st_size;
+    m_header       = static_cast<const snapshot_header*>(m_mapping);
+    m_array        = reinterpret_cast<const T*>(static_cast<const char*>(m_mapping) + snapshot_header_size);
+
+    try
+    {
+        detail::validate_snapshot_header<T>(*m_header);
+        size_t payload = m_mapped_bytes - snapshot_header_size - snapshot_trailer_size;
+        if (payload % sizeof(T) || m_header->count != payload / sizeof(T))
+            throw std::runtime_error("Snapshot size does not match its header");
+    }
+    catch (...)
+    {
+        munmap(m_mapping, m_mapped_bytes);
+        throw;
+    }
+}
+
+template <class T>
+snapshot_view<T>::~snapshot_view()
+{
+    if (m_mapping)
+        munmap(m_mapping, m_mapped_bytes);
+}
+
+template <class T>
+size_t snapshot_view<T>::size()
+{
+    return m_header->count;
+}
+
+template <class T>
+bool snapshot_view<T>::is_empty()
+{
+    return !m_header->count;
+}
+
+template <class T>
+bool snapshot_view<T>::verify()
+{
+    size_t            bytes = m_header->count * sizeof(T);
+    snapshot_checksum checksum;
+    checksum.update(m_array, bytes);
+
+    uint64_t sum;
+    memcpy(&sum, reinterpret_cast<const char*>(m_array) + bytes, sizeof(sum));
+    return sum == checksum.value();
+}
+
+template <class T>
+const T& snapshot_view<T>::at(const size_t index)
+{
+    if (index >= m_header->count)
+        throw std::out_of_range("Out of range index");
+
+    return *(m_array + index);
+}
+
+template <class T>
+const T* snapshot_view<T>::data()
+{
+    return m_array;
+}
+
+template <class T>
+const T* snapshot_view<T>::begin()
+{
+    return m_array;
+}
+
+template <class T>
+const T* snapshot_view<T>::end()
+{
+    return m_array + m_header->count;
+}
+
+} // namespace orla
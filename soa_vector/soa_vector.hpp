@@ -0,0 +1,364 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "vector.hpp"
+
+namespace orla
+{
+
+static const size_t soa_column_alignment = 64;
+
+/**
+ * column_span - non owning view over one column of a soa_vector
+ *
+ * Invalidated by any operation that changes the capacity of the vector.
+ */
+template <class T>
+class column_span
+{
+public:
+    column_span(T* data, const size_t size)
+        : m_data{ data }
+        , m_size{ size }
+    {
+    }
+
+    T* data()
+    {
+        return m_data;
+    }
+    size_t size()
+    {
+        return m_size;
+    }
+    T& operator[](const size_t index)
+    {
+        return *(m_data + index);
+    }
+    T* begin()
+    {
+        return m_data;
+    }
+    T* end()
+    {
+        return m_data + m_size;
+    }
+
+private:
+    T*     m_data;
+    size_t m_size;
+};
+
+namespace detail
+{
+template <class... Ts>
+struct all_trivially_copyable : std::true_type
+{
+};
+
+template <class T, class... Ts>
+struct all_trivially_copyable<T, Ts...>
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value && all_trivially_copyable<Ts...>::value>
+{
+};
+} // namespace detail
+
+/**
+ * soa_vector - vector of records stored field by field
+ *
+ * Every field lives in its own contiguous array aligned to soa_column_alignment
+ * bytes, all of them carved out of a single allocation. Loops touching a few
+ * fields only stream those columns through the cache. Growth and shrink policy
+ * is the same as orla::vector.
+ */
+template <class... Fields>
+class soa_vector
+{
+    static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+    static_assert(detail::all_trivially_copyable<Fields...>::value, "soa_vector fields must be trivially copyable");
+
+public:
+    template <size_t I>
+    using field_type = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+    typedef std::tuple<Fields...> row_type;
+
+    soa_vector();
+    soa_vector(const soa_vector& vector) = delete;
+    ~soa_vector();
+
+    size_t size();
+    size_t capacity();
+    bool   is_empty();
+
+    template <size_t I>
+    field_type<I>& at(const size_t index);
+    template <size_t I>
+    column_span<field_type<I>> column();
+    row_type row_at(const size_t index);
+
+    void     push(const Fields&... fields);
+    void     insert(const size_t index, const Fields&... fields);
+    void     prepend(const Fields&... fields);
+    row_type pop();
+    void     erase_at(const size_t index);
+
+private:
+    typedef std::index_sequence_for<Fields...> field_indices;
+    typedef int                                expand[];
+
+    /* data */
+    size_t                 m_capacity;
+    size_t                 m_size;
+    unsigned char*         m_allocation;
+    std::tuple<Fields*...> m_columns;
+
+    /* functions */
+    void resize(const size_t new_capacity);
+    void check_resize(bool will_add = true);
+    void shift(const size_t from, const size_t to, const size_t count);
+
+    template <size_t... I>
+    void write_row(const size_t index, std::index_sequence<I...>, const Fields&... fields);
+    template <size_t... I>
+    row_type read_row(const size_t index, std::index_sequence<I...>);
+    template <size_t... I>
+    void shift_columns(const size_t from, const size_t to, const size_t count, std::index_sequence<I...>);
+    template <size_t... I>
+    void copy_columns(std::tuple<Fields*...>& to, std::index_sequence<I...>);
+    template <size_t... I>
+    static std::tuple<Fields*...> layout(unsigned char* block, const size_t capacity, std::index_sequence<I...>);
+
+    static size_t         column_bytes(const size_t bytes);
+    static size_t         block_bytes(const size_t capacity);
+    static unsigned char* aligned_block(unsigned char* allocation);
+};
+
+template <class... Fields>
+soa_vector<Fields...>::soa_vector()
+    : m_capacity{ initial_vector_capacity }
+    , m_size{ 0 }
+    , m_allocation{ nullptr }
+{
+    m_allocation = new unsigned char[block_bytes(m_capacity)];
+    m_columns    = layout(aligned_block(m_allocation), m_capacity, field_indices());
+}
+
+template <class... Fields>
+soa_vector<Fields...>::~soa_vector()
+{
+    if (m_allocation)
+        delete[] m_allocation;
+}
+
+template <class... Fields>
+size_t soa_vector<Fields...>::size()
+{
+    return m_size;
+}
+
+template <class... Fields>
+size_t soa_vector<Fields...>::capacity()
+{
+    return m_capacity;
+}
+
+template <class... Fields>
+bool soa_vector<Fields...>::is_empty()
+{
+    return !m_size;
+}
+
+template <class... Fields>
+template <size_t I>
+typename soa_vector<Fields...>::template field_type<I>& soa_vector<Fields...>::at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return *(std::get<I>(m_columns) + index);
+}
+
+template <class... Fields>
+template <size_t I>
+column_span<typename soa_vector<Fields...>::template field_type<I>> soa_vector<Fields...>::column()
+{
+    return column_span<field_type<I>>(std::get<I>(m_columns), m_size);
+}
+
+template <class... Fields>
+typename soa_vector<Fields...>::row_type soa_vector<Fields...>::row_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    return read_row(index, field_indices());
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::push(const Fields&... fields)
+{
+    check_resize();
+
+    write_row(m_size, field_indices(), fields...);
+    m_size++;
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::insert(const size_t index, const Fields&... fields)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    check_resize();
+
+    shift(index, index + 1, m_size - index);
+    write_row(index, field_indices(), fields...);
+    m_size++;
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::prepend(const Fields&... fields)
+{
+    insert(0, fields...);
+}
+
+template <class... Fields>
+typename soa_vector<Fields...>::row_type soa_vector<Fields...>::pop()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty vector");
+
+    row_type ret = read_row(m_size - 1, field_indices());
+    m_size--;
+    check_resize(false);
+    return ret;
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::erase_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to delete item.");
+
+    shift(index + 1, index, m_size - index - 1);
+    m_size--;
+    check_resize(false);
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::resize(const size_t new_capacity)
+{
+    if (new_capacity < m_size)
+        throw std::logic_error("Loss of data due to resizing");
+
+    unsigned char*         allocation = new unsigned char[block_bytes(new_capacity)];
+    std::tuple<Fields*...> columns    = layout(aligned_block(allocation), new_capacity, field_indices());
+    copy_columns(columns, field_indices());
+
+    delete[] m_allocation;
+    m_allocation = allocation;
+    m_columns    = columns;
+    m_capacity   = new_capacity;
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::check_resize(bool will_add)
+{
+    if (will_add && m_size >= m_capacity)
+    {
+        resize(m_capacity * 2);
+    }
+    else if (!will_add && m_size && m_size <= m_capacity / 4)
+    {
+        resize(m_capacity / 2);
+    }
+}
+
+template <class... Fields>
+void soa_vector<Fields...>::shift(const size_t from, const size_t to, const size_t count)
+{
+    if (count)
+        shift_columns(from, to, count, field_indices());
+}
+
+template <class... Fields>
+template <size_t... I>
+void soa_vector<Fields...>::write_row(const size_t index, std::index_sequence<I...>, const Fields&... fields)
+{
+    (void)expand{ 0, (*(std::get<I>(m_columns) + index) = fields, 0)... };
+}
+
+template <class... Fields>
+template <size_t... I>
+typename soa_vector<Fields...>::row_type soa_vector<Fields...>::read_row(const size_t index, std::index_sequence<I...>)
+{
+    return row_type(*(std::get<I>(m_columns) + index)...);
+}
+
+template <class... Fields>
+template <size_t... I>
+void soa_vector<Fields...>::shift_columns(const size_t from,
+                                          const size_t to,
+                                          const size_t count,
+                                          std::index_sequence<I...>)
+{
+    (void)expand{ 0,
+                  (memmove(std::get<I>(m_columns) + to, std::get<I>(m_columns) + from, count * sizeof(Fields)),
+                   0)... };
+}
+
+template <class... Fields>
+template <size_t... I>
+void soa_vector<Fields...>::copy_columns(std::tuple<Fields*...>& to, std::index_sequence<I...>)
+{
+    (void)expand{ 0, (memcpy(std::get<I>(to), std::get<I>(m_columns), m_size * sizeof(Fields)), 0)... };
+}
+
+template <class... Fields>
+template <size_t... I>
+std::tuple<Fields*...> soa_vector<Fields...>::layout(unsigned char*       block,
+                                                     const size_t         capacity,
+                                                     std::index_sequence<I...>)
+{
+    std::tuple<Fields*...> columns;
+    size_t                 offset = 0;
+
+    (void)expand{ 0,
+                  (std::get<I>(columns) = reinterpret_cast<Fields*>(block + offset),
+                   offset += column_bytes(capacity * sizeof(Fields)),
+                   0)... };
+
+    return columns;
+}
+
+template <class... Fields>
+size_t soa_vector<Fields...>::column_bytes(const size_t bytes)
+{
+    return (bytes + soa_column_alignment - 1) / soa_column_alignment * soa_column_alignment;
+}
+
+template <class... Fields>
+size_t soa_vector<Fields...>::block_bytes(const size_t capacity)
+{
+    size_t total = 0;
+    (void)expand{ 0, (total += column_bytes(capacity * sizeof(Fields)), 0)... };
+
+    /* Slack to align the first column */
+    return total + soa_column_alignment;
+}
+
+template <class... Fields>
+unsigned char* soa_vector<Fields...>::aligned_block(unsigned char* allocation)
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(allocation);
+    address           = (address + soa_column_alignment - 1) / soa_column_alignment * soa_column_alignment;
+    return reinterpret_cast<unsigned char*>(address);
+}
+
+} // namespace orla
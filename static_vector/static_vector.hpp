@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include "bounds.hpp"
+
+namespace orla
+{
+
+/**
+ * Error policies for containers that must not allocate. A policy reports the
+ * error and never returns: it either throws or terminates the process. Index
+ * and emptiness checks go through a bounds policy as in orla::vector, and each
+ * error policy names the bounds policy that fails the same way it does.
+ */
+struct throw_error_policy
+{
+    typedef checked_bounds bounds;
+
+    [[noreturn]] static void overflow(const char* what)
+    {
+        throw std::length_error(what);
+    }
+    [[noreturn]] static void invalid_argument(const char* what)
+    {
+        throw std::invalid_argument(what);
+    }
+};
+
+struct abort_error_policy
+{
+    typedef abort_bounds bounds;
+
+    [[noreturn]] static void overflow(const char*)
+    {
+        std::abort();
+    }
+    [[noreturn]] static void invalid_argument(const char*)
+    {
+        std::abort();
+    }
+};
+
+/**
+ * static_vector - vector with a fixed capacity of N items stored inline
+ *
+ * Never touches the heap. Exceeding the capacity is reported through
+ * ErrorPolicy instead of growing. Bad indices and pops from an empty vector
+ * go to Bounds, so unchecked_bounds drops those checks as it does for
+ * orla::vector. For literal types T every operation is usable in constant
+ * expressions, provided the comparator is constexpr too.
+ */
+template <class T, size_t N, class ErrorPolicy = throw_error_policy, class Bounds = typename ErrorPolicy::bounds>
+class static_vector
+{
+    static_assert(N > 0, "static_vector needs a capacity of at least one item");
+
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    constexpr static_vector(item_comparator comparator);
+
+    constexpr size_t size() const;
+    constexpr size_t capacity() const;
+    constexpr bool   is_empty() const;
+    constexpr bool   is_full() const;
+
+    constexpr T&       at(const size_t index);
+    constexpr const T& at(const size_t index) const;
+    constexpr void     push(const T& item);
+    constexpr void     insert(const size_t index, const T& item);
+    constexpr void     prepend(const T& item);
+    constexpr T        pop();
+    constexpr void     erase_at(const size_t index);
+    constexpr void     remove(const T& item);
+    constexpr int      find(const T& item) const;
+
+private:
+    /* data */
+    size_t          m_size;
+    T               m_array[N];
+    item_comparator m_comparator;
+
+    /* functions */
+    constexpr int find_from_index(const size_t index, const T& item) const;
+};
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr static_vector<T, N, ErrorPolicy, Bounds>::static_vector(item_comparator comparator)
+    : m_size{ 0 }
+    , m_array{}
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+        ErrorPolicy::invalid_argument("Comparator cannot be null");
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr size_t static_vector<T, N, ErrorPolicy, Bounds>::size() const
+{
+    return m_size;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr size_t static_vector<T, N, ErrorPolicy, Bounds>::capacity() const
+{
+    return N;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr bool static_vector<T, N, ErrorPolicy, Bounds>::is_empty() const
+{
+    return !m_size;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr bool static_vector<T, N, ErrorPolicy, Bounds>::is_full() const
+{
+    return m_size == N;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr T& static_vector<T, N, ErrorPolicy, Bounds>::at(const size_t index)
+{
+    Bounds::check_index(index < m_size, "Out of range index");
+
+    return m_array[index];
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr const T& static_vector<T, N, ErrorPolicy, Bounds>::at(const size_t index) const
+{
+    Bounds::check_index(index < m_size, "Out of range index");
+
+    return m_array[index];
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr void static_vector<T, N, ErrorPolicy, Bounds>::push(const T& item)
+{
+    if (m_size == N)
+        ErrorPolicy::overflow("Cannot push to a full static_vector");
+
+    m_array[m_size] = item;
+    m_size++;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr void static_vector<T, N, ErrorPolicy, Bounds>::insert(const size_t index, const T& item)
+{
+    Bounds::check_index(index <= m_size, "Out of range index to insert item. Index should be <= size()");
+
+    if (m_size == N)
+        ErrorPolicy::overflow("Cannot insert into a full static_vector");
+
+    for (size_t i = m_size; i > index; --i)
+        m_array[i] = m_array[i - 1];
+
+    m_array[index] = item;
+    m_size++;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr void static_vector<T, N, ErrorPolicy, Bounds>::prepend(const T& item)
+{
+    insert(0, item);
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr T static_vector<T, N, ErrorPolicy, Bounds>::pop()
+{
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty vector");
+
+    m_size--;
+    return m_array[m_size];
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr void static_vector<T, N, ErrorPolicy, Bounds>::erase_at(const size_t index)
+{
+    Bounds::check_index(index < m_size, "Out of range index to delete item.");
+
+    for (size_t i = index; i < m_size - 1; ++i)
+        m_array[i] = m_array[i + 1];
+
+    m_size--;
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr void static_vector<T, N, ErrorPolicy, Bounds>::remove(const T& item)
+{
+    int index = 0;
+    while (-1 != (index = find_from_index(index, item)))
+        erase_at(index);
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr int static_vector<T, N, ErrorPolicy, Bounds>::find(const T& item) const
+{
+    return find_from_index(0, item);
+}
+
+template <class T, size_t N, class ErrorPolicy, class Bounds>
+constexpr int static_vector<T, N, ErrorPolicy, Bounds>::find_from_index(const size_t index, const T& item) const
+{
+    for (size_t i = index; i < m_size; ++i)
+    {
+        if (m_comparator(m_array[i], item))
+            return i;
+    }
+
+    return -1;
+}
+
+} // namespace orla
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace orla
+{
+
+struct container_stats
+{
+    uint64_t allocations;
+    uint64_t bytes_allocated;
+    uint64_t elements_moved;
+    uint64_t resizes;
+    uint64_t node_hops;
+    uint64_t comparisons;
+};
+
+/**
+ * null_stats - default stats policy of vector and the linked lists
+ *
+ * Containers inherit privately from their Stats policy and call its count_*
+ * hooks on allocations, item moves, resizes, node hops and comparator calls.
+ * Every hook of null_stats is empty and inline and the class holds no data,
+ * so instrumentation compiles out and costs no space. stats() always
+ * returns zeros and reset_stats() does nothing.
+ */
+class null_stats
+{
+public:
+    container_stats stats();
+    void            reset_stats();
+
+protected:
+    void count_allocation(const size_t bytes);
+    void count_moves(const size_t items);
+    void count_resize();
+    void count_hops(const size_t hops);
+    void count_comparisons(const size_t comparisons);
+};
+
+/**
+ * counting_stats - stats policy counting every event per container
+ *
+ * Each event is added to the counters of the container and, with relaxed
+ * atomics, to process wide counters aggregating all counting containers.
+ * Loops report their hops and comparisons once at the end, not per step.
+ *
+ *     orla::vector<int, orla::default_allocator<int>, orla::counting_stats> v(cmp);
+ *     orla::dump_stats(stderr, "requests", v.stats());
+ */
+class counting_stats
+{
+public:
+    counting_stats();
+
+    container_stats stats();
+    void            reset_stats();
+
+    static container_stats global_stats();
+    static void            reset_global_stats();
+
+protected:
+    void count_allocation(const size_t bytes);
+    void count_moves(const size_t items);
+    void count_resize();
+    void count_hops(const size_t hops);
+    void count_comparisons(const size_t comparisons);
+
+private:
+    /* data */
+    enum global_counter
+    {
+        counter_allocations,
+        counter_bytes_allocated,
+        counter_elements_moved,
+        counter_resizes,
+        counter_node_hops,
+        counter_comparisons,
+        counter_count
+    };
+
+    container_stats m_stats;
+
+    /* functions */
+    static std::atomic<uint64_t>* global_counters();
+};
+
+/* Writes the counters as one key=value line, prefixed by label */
+inline void dump_stats(FILE* out, const char* label, const container_stats& stats)
+{
+    fprintf(out,
+            "%s: allocations=%llu bytes_allocated=%llu elements_moved=%llu resizes=%llu node_hops=%llu "
+            "comparisons=%llu\n",
+            label,
+            static_cast<unsigned long long>(stats.allocations),
+            static_cast<unsigned long long>(stats.bytes_allocated),
+            static_cast<unsigned long long>(stats.elements_moved),
+            static_cast<unsigned long long>(stats.resizes),
+            static_cast<unsigned long long>(stats.node_hops),
+            static_cast<unsigned long long>(stats.comparisons));
+}
+
+inline container_stats null_stats::stats()
+{
+    return container_stats{ 0, 0, 0, 0, 0, 0 };
+}
+
+inline void null_stats::reset_stats()
+{
+}
+
+inline void null_stats::count_allocation(const size_t)
+{
+}
+
+inline void null_stats::count_moves(const size_t)
+{
+}
+
+inline void null_stats::count_resize()
+{
+}
+
+inline void null_stats::count_hops(const size_t)
+{
+}
+
+inline void null_stats::count_comparisons(const size_t)
+{
+}
+
+inline counting_stats::counting_stats()
+    : m_stats{ 0, 0, 0, 0, 0, 0 }
+{
+}
+
+inline container_stats counting_stats::stats()
+{
+    return m_stats;
+}
+
+inline void counting_stats::reset_stats()
+{
+    m_stats = container_stats{ 0, 0, 0, 0, 0, 0 };
+}
+
+inline container_stats counting_stats::global_stats()
+{
+    std::atomic<uint64_t>* counters = global_counters();
+    return container_stats{ counters[counter_allocations].load(std::memory_order_relaxed),
+                            counters[counter_bytes_allocated].load(std::memory_order_relaxed),
+                            counters[counter_elements_moved].load(std::memory_order_relaxed),
+                            counters[counter_resizes].load(std::memory_order_relaxed),
+                            counters[counter_node_hops].load(std::memory_order_relaxed),
+                            counters[counter_comparisons].load(std::memory_order_relaxed) };
+}
+
+inline void counting_stats::reset_global_stats()
+{
+    std::atomic<uint64_t>* counters = global_counters();
+    for (size_t i = 0; i < counter_count; ++i)
+        counters[i].store(0, std::memory_order_relaxed);
+}
+
+inline void counting_stats::count_allocation(const size_t bytes)
+{
+    m_stats.allocations++;
+    m_stats.bytes_allocated += bytes;
+    global_counters()[counter_allocations].fetch_add(1, std::memory_order_relaxed);
+    global_counters()[counter_bytes_allocated].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+inline void counting_stats::count_moves(const size_t items)
+{
+    m_stats.elements_moved += items;
+    global_counters()[counter_elements_moved].fetch_add(items, std::memory_order_relaxed);
+}
+
+inline void counting_stats::count_resize()
+{
+    m_stats.resizes++;
+    global_counters()[counter_resizes].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void counting_stats::count_hops(const size_t hops)
+{
+    m_stats.node_hops += hops;
+    global_counters()[counter_node_hops].fetch_add(hops, std::memory_order_relaxed);
+}
+
+inline void counting_stats::count_comparisons(const size_t comparisons)
+{
+    m_stats.comparisons += comparisons;
+    global_counters()[counter_comparisons].fetch_add(comparisons, std::memory_order_relaxed);
+}
+
+/* Function local so the header-only counters exist once per process */
+inline std::atomic<uint64_t>* counting_stats::global_counters()
+{
+    static std::atomic<uint64_t> counters[counter_count] = {};
+    return counters;
+}
+
+} // namespace orla
@@ -1,13 +1,62 @@
+#include <algorithm>
 #include <cassert>
+#include <string>
+#include <thread>
 #include "vector.hpp"
 #include "doubly_linked_list.hpp"
 #include "singly_linked_list.hpp"
+#include "parallel.hpp"
+#include "soa_vector.hpp"
+#include "static_vector.hpp"
+#include "mmap_vector.hpp"
+#include "unrolled_list.hpp"
+#include "compact_list.hpp"
+#include "lru_cache.hpp"
+#include "views.hpp"
+#include "incremental_vector.hpp"
+#include "huge_page_allocator.hpp"
+#include "snapshot.hpp"
+#include "stats.hpp"
+#include "bounds.hpp"
+#include "priority_queue.hpp"
+#include "external_sort.hpp"
+#include "persistent_vector.hpp"
+#include "packed_vector.hpp"
+#include "bit_vector.hpp"
 
 bool int_comparator(const int& a, const int& b)
 {
     return a == b;
 }
 
+bool long_long_comparator(const long long& a, const long long& b)
+{
+    return a == b;
+}
+
+/* No default constructor and no assignment */
+struct labelled_item
+{
+    explicit labelled_item(int v)
+        : value{ v }
+    {
+    }
+    labelled_item(const labelled_item& other) = default;
+    labelled_item& operator=(const labelled_item& other) = delete;
+
+    const int value;
+};
+
+bool labelled_item_comparator(const labelled_item& a, const labelled_item& b)
+{
+    return a.value == b.value;
+}
+
+constexpr bool constexpr_int_comparator(const int& a, const int& b)
+{
+    return a == b;
+}
+
 void test_vector()
 {
     ::orla::vector<int> vec(int_comparator);
@@ -81,6 +130,17 @@ void test_vector()
     assert(vec.size() == 0);
     assert(vec.is_empty());
     assert(vec.capacity() == 2);
+
+    /* test truncate shrinks once to fit */
+    for (int i = 0; i < 100; ++i)
+        vec.push(i);
+    assert(vec.capacity() == 128);
+    vec.truncate(10);
+    assert(vec.size() == 10);
+    assert(vec.capacity() == 32);
+    assert(vec.at(9) == 9);
+    vec.truncate(10);
+    assert(vec.size() == 10);
 }
 
 void test_doubly_linked_list()
@@ -197,6 +257,170 @@ void test_doubly_linked_list()
     assert(list.size() == 0);
 }
 
+void test_doubly_linked_list_relayout()
+{
+    ::orla::doubly_linked_list<int> list(int_comparator);
+    ::orla::doubly_linked_list<int> decoy(int_comparator);
+
+    /* interleave allocations of two lists and insert out of order to scatter nodes */
+    for (int i = 0; i < 1000; ++i)
+    {
+        list.insert(list.size() / 2, i);
+        decoy.push_back(i);
+    }
+    assert(list.average_stride() > ::orla::doubly_linked_list<int>::node_stride());
+
+    ::orla::doubly_linked_list<int> expected(int_comparator);
+    for (size_t i = 0; i < list.size(); ++i)
+        expected.push_back(list.value_at(i));
+
+    list.relayout();
+    assert(!list.is_relayout_pending());
+    assert(list.average_stride() == ::orla::doubly_linked_list<int>::node_stride());
+    assert(list.size() == 1000);
+    for (size_t i = 0; i < list.size(); ++i)
+        assert(list.value_at(i) == expected.value_at(i));
+    assert(list.value_n_from_end(0) == expected.back());
+
+    /* freed slab nodes are reused */
+    list.erase(10);
+    list.insert(10, expected.value_at(10));
+    assert(list.average_stride() == ::orla::doubly_linked_list<int>::node_stride());
+
+    /* incremental passes survive mutations between steps */
+    list.reverse();
+    assert(!list.relayout_step(100));
+    assert(list.is_relayout_pending());
+    list.pop_front();
+    list.push_back(-1);
+    list.erase(150);
+    list.remove_value(expected.value_at(500));
+    size_t steps = 1;
+    while (!list.relayout_step(100))
+        steps++;
+    assert(steps == 9);
+    assert(list.size() == 998);
+    assert(list.back() == -1);
+    assert(list.average_stride() == ::orla::doubly_linked_list<int>::node_stride());
+
+    assert(!list.relayout_step(10));
+    list.reverse();
+    assert(!list.is_relayout_pending());
+    assert(list.front() == -1);
+
+    while (!list.is_empty())
+        list.pop_back();
+    assert(list.relayout_step(10));
+
+    /* a reserved slab outlives its last node and is refilled without allocating */
+    ::orla::doubly_linked_list<int, ::orla::counting_stats> reserved(int_comparator);
+    reserved.reserve(64);
+    reserved.reserve(64);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 128; ++i)
+            reserved.push_back(i);
+        while (!reserved.is_empty())
+            reserved.pop_front();
+    }
+    assert(reserved.stats().allocations == 2);
+
+    /* slab nodes construct and destroy items instead of assigning them */
+    ::orla::doubly_linked_list<labelled_item> labelled(labelled_item_comparator);
+    labelled.reserve(4);
+    labelled.push_back(labelled_item(1));
+    labelled.push_front(labelled_item(0));
+    labelled.erase(0);
+    labelled.push_back(labelled_item(2));
+    assert(labelled.front().value == 1);
+    assert(labelled.back().value == 2);
+}
+
+void test_doubly_linked_list_handles()
+{
+    ::orla::doubly_linked_list<int> list(int_comparator);
+
+    ::orla::doubly_linked_list<int>::node_handle two = list.push_back_node(2);
+    ::orla::doubly_linked_list<int>::node_handle one = list.push_front_node(1);
+    list.push_back(3);
+    assert(list.size() == 3);
+    assert(list.front_node() == one);
+    assert(list.value_of(two) == 2);
+
+    list.move_to_front(two);
+    assert(list.value_at(0) == 2);
+    assert(list.value_at(1) == 1);
+    assert(list.value_at(2) == 3);
+
+    list.move_to_back(one);
+    assert(list.back_node() == one);
+    assert(list.value_n_from_end(1) == 3);
+
+    list.erase_node(list.back_node());
+    assert(list.size() == 2);
+    assert(list.back() == 3);
+
+    list.erase_node(two);
+    list.erase_node(list.front_node());
+    assert(list.is_empty());
+    assert(list.front_node() == nullptr);
+}
+
+template <class List>
+void check_batched_access(List& list)
+{
+    for (int i = 0; i < 100; ++i)
+        list.push_back(i);
+
+    const size_t indices[] = { 5, 99, 0, 50, 5, 49 };
+    int*         values[6];
+    list.value_at_many(indices, 6, values);
+    for (size_t i = 0; i < 6; ++i)
+        assert(*values[i] == (int)indices[i]);
+    assert(values[0] == values[4]);
+
+    *values[3] = -50;
+    assert(list.value_at(50) == -50);
+
+    const size_t erased[] = { 10, 90, 10, 0, 99, 51, 50 };
+    assert(list.erase_many(erased, 7) == 6);
+    assert(list.size() == 94);
+    assert(list.front() == 1);
+    assert(list.back() == 98);
+
+    int expected = 1;
+    for (size_t i = 0; i < list.size(); ++i, ++expected)
+    {
+        while (expected == 10 || expected == 50 || expected == 51 || expected == 90)
+            expected++;
+        assert(list.value_at(i) == expected);
+    }
+
+    bool         threw          = false;
+    const size_t out_of_range[] = { 1, 94 };
+    try
+    {
+        list.erase_many(out_of_range, 2);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    assert(threw);
+    assert(list.size() == 94);
+
+    assert(list.erase_many(nullptr, 0) == 0);
+}
+
+void test_list_batched_access()
+{
+    ::orla::doubly_linked_list<int> doubly(int_comparator);
+    check_batched_access(doubly);
+
+    ::orla::singly_linked_list<int> singly(int_comparator);
+    check_batched_access(singly);
+}
+
 void test_singly_linked_list()
 {
     ::orla::singly_linked_list<int> list(int_comparator);
@@ -311,11 +535,1739 @@ void test_singly_linked_list()
     assert(list.size() == 0);
 }
 
+void test_parallel()
+{
+    ::orla::thread_pool      pool(4);
+    ::orla::parallel_options options;
+    options.pool       = &pool;
+    options.grain_size = 1000;
+
+    ::orla::vector<int> vec(int_comparator);
+    for (int i = 0; i < 100000; ++i)
+        vec.push(i);
+
+    ::orla::parallel::for_each(vec, [](int& item) { item += 1; }, options);
+    assert(vec.at(0) == 1);
+    assert(vec.at(99999) == 100000);
+
+    ::orla::parallel::transform(vec, [](int item) { return item - 1; }, options);
+    assert(vec.at(0) == 0);
+    assert(vec.at(99999) == 99999);
+
+    ::orla::vector<int> doubled(int_comparator);
+    doubled.push(-1);
+    ::orla::parallel::transform(vec, doubled, [](int item) { return item * 2; }, options);
+    assert(doubled.size() == 100001);
+    assert(doubled.at(0) == -1);
+    assert(doubled.at(1) == 0);
+    assert(doubled.at(100000) == 199998);
+
+    int max = ::orla::parallel::reduce(doubled, 0, [](int a, int b) { return a > b ? a : b; }, options);
+    assert(max == 199998);
+
+    assert(::orla::parallel::count_if(vec, [](int item) { return item % 3 == 0; }, options) == 33334);
+
+    assert(::orla::parallel::find_first(vec, [](int item) { return item >= 54321; }, options) == 54321);
+    assert(::orla::parallel::find_first(vec, [](int item) { return item % 7 == 6; }, options) == 6);
+    assert(::orla::parallel::find_first(vec, [](int item) { return item < 0; }, options) == -1);
+
+    size_t removed = ::orla::parallel::remove_if(vec, [](int item) { return item % 2; }, options);
+    assert(removed == 50000);
+    assert(vec.size() == 50000);
+    for (size_t i = 0; i < vec.size(); ++i)
+        assert(vec.at(i) == (int)i * 2);
+
+    /* small inputs take the serial path */
+    ::orla::vector<int> small(int_comparator);
+    for (int i = 0; i < 10; ++i)
+        small.push(i);
+    assert(::orla::parallel::reduce(small, 0, [](int a, int b) { return a + b; }, options) == 45);
+    assert(::orla::parallel::remove_if(small, [](int item) { return item < 5; }, options) == 5);
+    assert(small.size() == 5);
+    assert(small.at(0) == 5);
+    assert(::orla::parallel::find_first(small, [](int item) { return item == 9; }) == 4);
+}
+
+void test_soa_vector()
+{
+    ::orla::soa_vector<int, double, char> vec;
+
+    assert(vec.is_empty());
+    assert(vec.capacity() == ::orla::initial_vector_capacity);
+
+    vec.push(1, 1.5, 'a');
+    vec.push(2, 2.5, 'b');
+    vec.insert(1, 3, 3.5, 'c');
+    vec.prepend(4, 4.5, 'd');
+    assert(vec.size() == 4);
+    assert(vec.at<0>(0) == 4);
+    assert(vec.at<0>(1) == 1);
+    assert(vec.at<0>(2) == 3);
+    assert(vec.at<0>(3) == 2);
+    assert(vec.at<1>(2) == 3.5);
+    assert(vec.at<2>(3) == 'b');
+
+    std::tuple<int, double, char> row = vec.row_at(1);
+    assert(std::get<0>(row) == 1);
+    assert(std::get<1>(row) == 1.5);
+    assert(std::get<2>(row) == 'a');
+
+    vec.erase_at(1);
+    assert(vec.size() == 3);
+    assert(vec.at<0>(1) == 3);
+    assert(vec.at<2>(1) == 'c');
+
+    row = vec.pop();
+    assert(std::get<0>(row) == 2);
+    assert(vec.size() == 2);
+
+    /* columns are contiguous and aligned after growing */
+    for (int i = 0; i < 100; ++i)
+        vec.push(i, i * 0.5, 'x');
+    assert(vec.size() == 102);
+    assert(vec.capacity() == 128);
+
+    ::orla::column_span<double> weights = vec.column<1>();
+    assert(weights.size() == 102);
+    assert(reinterpret_cast<uintptr_t>(weights.data()) % ::orla::soa_column_alignment == 0);
+    assert(reinterpret_cast<uintptr_t>(vec.column<2>().data()) % ::orla::soa_column_alignment == 0);
+
+    double sum = 0;
+    for (double weight : weights)
+        sum += weight;
+    assert(sum == 4.5 + 3.5 + 99 * 100 / 2 * 0.5);
+
+    weights[2] = 7.0;
+    assert(vec.at<1>(2) == 7.0);
+
+    while (vec.size() > 3)
+        vec.erase_at(0);
+    assert(vec.capacity() == 8);
+    assert(vec.at<0>(0) == 97);
+    assert(vec.at<0>(2) == 99);
+    assert(vec.at<1>(2) == 49.5);
+}
+
+constexpr ::orla::static_vector<int, 8> make_static_vector()
+{
+    ::orla::static_vector<int, 8> vec(constexpr_int_comparator);
+    vec.push(1);
+    vec.push(2);
+    vec.insert(1, 3);
+    vec.prepend(4);
+    vec.push(3);
+    vec.erase_at(2);
+    vec.remove(3);
+    return vec;
+}
+
+void test_static_vector()
+{
+    constexpr ::orla::static_vector<int, 8> built = make_static_vector();
+    static_assert(built.size() == 3, "constexpr static_vector size");
+    static_assert(built.at(0) == 4, "constexpr static_vector at");
+    static_assert(built.at(1) == 1, "constexpr static_vector at");
+    static_assert(built.at(2) == 2, "constexpr static_vector at");
+    static_assert(built.find(2) == 2, "constexpr static_vector find");
+
+    ::orla::static_vector<int, 4> vec(int_comparator);
+    assert(vec.is_empty());
+    assert(vec.capacity() == 4);
+
+    vec.push(1);
+    vec.push(2);
+    vec.insert(1, 3);
+    vec.prepend(4);
+    assert(vec.is_full());
+    assert(vec.at(0) == 4);
+    assert(vec.at(1) == 1);
+    assert(vec.at(2) == 3);
+    assert(vec.at(3) == 2);
+    assert(vec.find(3) == 2);
+
+    bool threw = false;
+    try
+    {
+        vec.push(5);
+    }
+    catch (const std::length_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+    assert(vec.size() == 4);
+
+    threw = false;
+    try
+    {
+        vec.at(4);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    vec.erase_at(1);
+    assert(vec.size() == 3);
+    assert(vec.at(1) == 3);
+
+    vec.push(4);
+    vec.remove(4);
+    assert(vec.size() == 2);
+    assert(vec.find(4) == -1);
+
+    assert(vec.pop() == 2);
+    assert(vec.pop() == 3);
+    assert(vec.is_empty());
+
+    /* Bounds follows the error policy unless given, as for orla::vector */
+    static_assert(std::is_same<::orla::abort_error_policy::bounds, ::orla::abort_bounds>::value,
+                  "abort_error_policy aborts on bad indices too");
+    ::orla::static_vector<int, 4, ::orla::throw_error_policy, ::orla::unchecked_bounds> unchecked(int_comparator);
+    unchecked.push(7);
+    unchecked.push(8);
+    unchecked.erase_at(0);
+    assert(unchecked.at(0) == 8);
+    assert(unchecked.pop() == 8);
+
+    threw = false;
+    try
+    {
+        unchecked.push(1);
+        unchecked.push(2);
+        unchecked.push(3);
+        unchecked.push(4);
+        unchecked.push(5);
+    }
+    catch (const std::length_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_mmap_vector()
+{
+    char path[] = "/tmp/orla_mmap_vector_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    {
+        ::orla::mmap_vector<int> vec(path, int_comparator, ::orla::mmap_open_mode::create);
+        assert(vec.is_empty());
+        assert(vec.capacity() == ::orla::initial_vector_capacity);
+
+        for (int i = 0; i < 100; ++i)
+            vec.push(i);
+        assert(vec.size() == 100);
+        assert(vec.capacity() == 128);
+        vec.flush();
+    }
+
+    {
+        ::orla::mmap_vector<int> vec(path, int_comparator);
+        assert(vec.size() == 100);
+        assert(vec.capacity() == 128);
+        assert(vec.at(0) == 0);
+        assert(vec.at(99) == 99);
+
+        vec.insert(1, 1000);
+        vec.prepend(7);
+        assert(vec.at(0) == 7);
+        assert(vec.at(1) == 0);
+        assert(vec.at(2) == 1000);
+        assert(vec.find(1000) == 2);
+
+        vec.erase_at(0);
+        vec.remove(1000);
+        assert(vec.size() == 100);
+        assert(vec.find(1000) == -1);
+        assert(vec.pop() == 99);
+
+        vec.shrink_to_fit();
+        assert(vec.capacity() == 99);
+        vec.push(99);
+        assert(vec.capacity() == 198);
+    }
+
+    {
+        ::orla::mmap_vector<int> vec(path, int_comparator, ::orla::mmap_open_mode::read_only);
+        assert(vec.is_read_only());
+        assert(vec.size() == 100);
+        for (size_t i = 0; i < vec.size(); ++i)
+            assert(vec.at(i) == (int)i);
+
+        bool threw = false;
+        try
+        {
+            vec.push(1);
+        }
+        catch (const std::logic_error&)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    bool threw = false;
+    try
+    {
+        /* item size recorded in the header does not match */
+        ::orla::mmap_vector<long long> vec(path, long_long_comparator);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* a capacity whose byte size wraps to zero must not pass validation */
+    fd = open(path, O_RDWR);
+    assert(fd >= 0);
+    uint64_t capacity = 1ULL << 62;
+    assert(pwrite(fd, &capacity, sizeof(capacity), offsetof(::orla::mmap_vector_header, capacity)) ==
+           sizeof(capacity));
+    close(fd);
+
+    threw = false;
+    try
+    {
+        ::orla::mmap_vector<int> vec(path, int_comparator);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    unlink(path);
+}
+
+void test_unrolled_list()
+{
+    static_assert(::orla::unrolled_list_default_block_size<int>() == 10, "int blocks fill a cache line");
+
+    ::orla::unrolled_list<int, 4> list(int_comparator);
+    assert(list.is_empty());
+
+    list.insert(0, 1);
+    assert(list.size() == 1);
+    int res = list.pop_back();
+    assert(res == 1);
+    assert(list.is_empty());
+    assert(list.blocks() == 0);
+
+    list.push_front(2);
+    list.push_front(1);
+    list.push_back(3);
+    assert(list.size() == 3);
+    assert(list.front() == 1);
+    assert(list.back() == 3);
+    assert(list.pop_front() == 1);
+    assert(list.pop_back() == 3);
+    assert(list.pop_front() == 2);
+    assert(list.is_empty());
+
+    /* sequential pushes fill whole blocks */
+    for (int i = 0; i < 12; ++i)
+        list.push_back(i);
+    assert(list.blocks() == 3);
+
+    /* inserting into a full block splits it */
+    list.insert(2, 100);
+    assert(list.blocks() == 4);
+    assert(list.size() == 13);
+    assert(list.value_at(1) == 1);
+    assert(list.value_at(2) == 100);
+    assert(list.value_at(3) == 2);
+    assert(list.value_at(12) == 11);
+    assert(list.value_n_from_end(0) == 11);
+    assert(list.value_n_from_end(10) == 100);
+    assert(list.value_n_from_end(12) == 0);
+
+    list.erase(2);
+    list.remove_value(3);
+    list.remove_value(42);
+    assert(list.size() == 11);
+    assert(list.value_at(2) == 2);
+    assert(list.value_at(3) == 4);
+
+    /* erasing keeps blocks at least half full */
+    list.erase(3);
+    list.erase(3);
+    assert(list.blocks() == 3);
+    for (size_t i = 0, expected = 0; i < list.size(); ++i, ++expected)
+    {
+        if (expected == 3)
+            expected = 6;
+        assert(list.value_at(i) == (int)expected);
+    }
+
+    list.reverse();
+    assert(list.front() == 11);
+    assert(list.back() == 0);
+    assert(list.value_at(5) == 6);
+    assert(list.value_n_from_end(2) == 2);
+
+    list.reverse();
+    assert(list.front() == 0);
+    assert(list.back() == 11);
+
+    /* compare against a plain array under mixed operations */
+    int    model[64];
+    size_t model_size = 0;
+    ::orla::unrolled_list<int, 4> mixed(int_comparator);
+    for (int i = 0; i < 200; ++i)
+    {
+        size_t index = (size_t)(i * 7) % (model_size + 1);
+        if (model_size < 64 && (i % 3 || !model_size))
+        {
+            for (size_t j = model_size; j > index; --j)
+                model[j] = model[j - 1];
+            model[index] = i;
+            model_size++;
+            mixed.insert(index, i);
+        }
+        else
+        {
+            index %= model_size;
+            for (size_t j = index; j + 1 < model_size; ++j)
+                model[j] = model[j + 1];
+            model_size--;
+            mixed.erase(index);
+        }
+
+        assert(mixed.size() == model_size);
+        assert(mixed.blocks() <= model_size / 2 + 1);
+        for (size_t j = 0; j < model_size; ++j)
+            assert(mixed.value_at(j) == model[j]);
+    }
+
+    /* alternating work at both ends leaves no sparse blocks behind */
+    ::orla::unrolled_list<int, 4> ends(int_comparator);
+    for (int i = 0; i < 8; ++i)
+        ends.push_back(i);
+    for (int i = 0; i < 100; ++i)
+    {
+        ends.push_front(-i);
+        ends.push_back(i);
+        ends.erase(ends.size() - 2);
+        ends.pop_front();
+        ends.push_front(i);
+        assert(ends.blocks() <= ends.size() / 2 + 1);
+    }
+    assert(ends.size() == 108);
+    ends.reverse();
+    while (ends.size() > 3)
+    {
+        ends.erase(ends.size() - 1);
+        ends.erase(ends.size() - 1);
+        ends.erase(ends.size() / 2);
+        assert(ends.blocks() <= ends.size() / 2 + 1);
+    }
+}
+
+void test_compact_list()
+{
+    ::orla::compact_list<int> list(int_comparator);
+    assert(list.is_empty());
+    assert(list.capacity() == ::orla::initial_compact_list_capacity);
+
+    list.insert(0, 1);
+    assert(list.size() == 1);
+    assert(list.pop_back() == 1);
+    assert(list.is_empty());
+
+    list.push_front(2);
+    list.push_front(1);
+    list.push_back(3);
+    assert(list.size() == 3);
+    assert(list.front() == 1);
+    assert(list.back() == 3);
+    assert(list.value_at(1) == 2);
+
+    list.insert(3, 5);
+    list.insert(3, 4);
+    list.insert(0, 0);
+    assert(list.size() == 6);
+    for (size_t i = 0; i < list.size(); ++i)
+        assert(list.value_at(i) == (int)i);
+    assert(list.value_n_from_end(0) == 5);
+    assert(list.value_n_from_end(5) == 0);
+
+    list.erase(2);
+    list.erase(4);
+    assert(list.size() == 4);
+    assert(list.value_at(1) == 1);
+    assert(list.value_at(2) == 3);
+    assert(list.back() == 4);
+
+    list.reverse();
+    assert(list.front() == 4);
+    assert(list.back() == 0);
+    assert(list.value_at(1) == 3);
+    assert(list.value_n_from_end(0) == 0);
+    assert(list.value_n_from_end(3) == 4);
+
+    list.remove_value(3);
+    assert(list.size() == 3);
+    assert(list.value_at(1) == 1);
+    assert(list.pop_front() == 4);
+    assert(list.pop_back() == 0);
+    assert(list.pop_back() == 1);
+    assert(list.is_empty());
+
+    /* freed nodes are reused before the pool grows */
+    for (int i = 0; i < 16; ++i)
+        list.push_back(i);
+    assert(list.capacity() == 16);
+    list.push_back(16);
+    assert(list.capacity() == 32);
+    for (int i = 0; i < 17; ++i)
+        assert(list.value_at(i) == i);
+    while (!list.is_empty())
+        list.pop_front();
+    for (int i = 0; i < 32; ++i)
+        list.push_front(i);
+    assert(list.capacity() == 32);
+    assert(list.front() == 31);
+    assert(list.back() == 0);
+}
+
+size_t string_entry_size(const int&, const std::string& value)
+{
+    return value.size();
+}
+
+void test_lru_cache()
+{
+    ::orla::lru_cache<int, std::string> cache(3);
+    std::string                         value;
+
+    assert(cache.is_empty());
+    assert(!cache.get(1, value));
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+    assert(cache.size() == 3);
+
+    /* touching 1 makes 2 the least recently used entry */
+    assert(cache.get(1, value));
+    assert(value == "one");
+    cache.put(4, "four");
+    assert(cache.size() == 3);
+    assert(!cache.get(2, value));
+    assert(cache.find(3) != nullptr);
+    assert(*cache.find(4) == "four");
+
+    cache.put(1, "uno");
+    cache.put(5, "five");
+    assert(!cache.get(3, value));
+    assert(cache.get(1, value));
+    assert(value == "uno");
+
+    assert(cache.erase(4));
+    assert(!cache.erase(4));
+    assert(cache.size() == 2);
+
+    ::orla::lru_cache_stats stats = cache.stats();
+    assert(stats.hits == 4);
+    assert(stats.misses == 3);
+    assert(stats.evictions == 2);
+
+    cache.clear();
+    assert(cache.is_empty());
+    assert(cache.used() == 0);
+
+    /* byte budget */
+    ::orla::lru_cache<int, std::string> sized(10, string_entry_size);
+    assert(sized.put(1, "aaaa"));
+    assert(sized.put(2, "bbbb"));
+    assert(sized.used() == 8);
+    assert(sized.put(3, "cc"));
+    assert(sized.used() == 10);
+    assert(sized.put(4, "d"));
+    assert(sized.size() == 3);
+    assert(!sized.get(1, value));
+    assert(!sized.put(5, "this does not fit"));
+    assert(sized.size() == 3);
+
+    ::orla::sharded_lru_cache<int, int> sharded(4, 400);
+    assert(sharded.shards() == 4);
+    for (int i = 0; i < 1000; ++i)
+        sharded.put(i, i * 2);
+    assert(sharded.size() <= 400);
+
+    int out = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (sharded.get(i, out))
+            assert(out == i * 2);
+    }
+
+    ::orla::lru_cache_stats sharded_stats = sharded.stats();
+    assert(sharded_stats.hits + sharded_stats.misses == 1000);
+    assert(sharded_stats.hits == sharded.size());
+    assert(sharded_stats.evictions == 1000 - sharded.size());
+}
+
+void test_views()
+{
+    namespace views = ::orla::views;
+
+    ::orla::vector<int>             numbers(int_comparator);
+    ::orla::doubly_linked_list<int> doubly(int_comparator);
+    ::orla::singly_linked_list<int> singly(int_comparator);
+    for (int i = 0; i < 20; ++i)
+    {
+        numbers.push(i);
+        doubly.push_back(i);
+        singly.push_back(i);
+    }
+
+    auto is_even = [](int n) { return n % 2 == 0; };
+    auto square  = [](int n) { return n * n; };
+
+    /* Stages fuse: only the elements reaching take() are squared */
+    int  squared  = 0;
+    auto counted  = [&squared](int n) { squared++; return n * n; };
+    int  expected = 0;
+    for (int n : numbers | views::filter(is_even) | views::transform(counted) | views::take(3))
+    {
+        assert(n == expected * expected);
+        expected += 2;
+    }
+    assert(expected == 6);
+    assert(squared == 3);
+
+    ::orla::vector<int> collected(int_comparator);
+    views::materialize(singly | views::drop(15) | views::transform(square), collected);
+    assert(collected.size() == 5);
+    assert(collected.at(0) == 225);
+    assert(collected.at(4) == 361);
+
+    /* Reversing a doubly_linked_list view leaves the list untouched */
+    expected = 19;
+    for (int n : doubly | views::reversed())
+        assert(n == expected--);
+    assert(expected == -1);
+    assert(doubly.front() == 0);
+
+    ::orla::doubly_linked_list<int> tail(int_comparator);
+    views::materialize(doubly | views::transform(square) | views::reversed() | views::take(2), tail);
+    assert(tail.size() == 2);
+    assert(tail.front() == 361);
+    assert(tail.back() == 324);
+
+    expected = 19;
+    for (int n : numbers | views::reversed() | views::filter(is_even))
+    {
+        assert(n == expected - 1);
+        expected -= 2;
+    }
+
+    /* Stage state captured by value lives in the view that reversed() keeps */
+    int  offset    = 100;
+    int  threshold = 15;
+    auto shifted   = [offset](int n) { return n + offset; };
+    auto above     = [threshold](int n) { return n > threshold; };
+    auto backwards = doubly | views::filter(above) | views::transform(shifted) | views::reversed();
+    expected       = 119;
+    for (int n : backwards)
+        assert(n == expected--);
+    assert(expected == 115);
+
+    /* Chunks are views themselves, the last one holds the remainder */
+    size_t chunks = 0;
+    int    sum    = 0;
+    for (auto chunk : doubly | views::chunk(6))
+    {
+        size_t items = 0;
+        for (int n : chunk)
+        {
+            sum += n;
+            items++;
+        }
+        assert(items == (chunks < 3 ? 6u : 2u));
+        chunks++;
+    }
+    assert(chunks == 4);
+    assert(sum == 190);
+
+    auto evens = views::all(singly) | views::filter(is_even);
+    singly.push_back(20);
+    int count = 0;
+    for (int n : evens | views::drop(100))
+        count += n;
+    assert(count == 0);
+    for (int n : evens)
+        count += n;
+    assert(count == 110);
+
+    ::orla::vector<int> empty(int_comparator);
+    for (int n : empty | views::filter(is_even) | views::take(4))
+        assert(n < 0);
+    assert((empty | views::chunk(3)).begin() == (empty | views::chunk(3)).end());
+
+    bool threw = false;
+    try
+    {
+        views::chunk(0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_incremental_vector()
+{
+    ::orla::incremental_vector<int> vector(int_comparator);
+    assert(vector.is_empty());
+
+    for (int i = 0; i < 16; ++i)
+        vector.push(i);
+    assert(!vector.is_migrating());
+    assert(vector.capacity() == 16);
+
+    /* Crossing the capacity only swaps buffers, items move over later pushes */
+    vector.push(16);
+    assert(vector.is_migrating());
+    assert(vector.capacity() == 32);
+    for (int i = 0; i <= 16; ++i)
+        assert(vector.at(i) == i);
+
+    vector.at(10) = 100;
+    assert(vector.find(100) == 10);
+    vector.at(10) = 10;
+
+    assert(vector.pop() == 16);
+    assert(vector.pop() == 15);
+    assert(vector.is_migrating());
+    for (int i = 15; i < 200; ++i)
+    {
+        vector.push(i);
+        for (int j = 0; j <= i; j += 7)
+            assert(vector.at(j) == j);
+    }
+    assert(vector.size() == 200);
+    assert(vector.capacity() == 256);
+
+    vector.insert(0, -1);
+    assert(!vector.is_migrating());
+    vector.erase_at(0);
+    int* data = vector.data();
+    for (int i = 0; i < 200; ++i)
+        assert(data[i] == i);
+
+    vector.insert(3, 3);
+    vector.prepend(3);
+    vector.remove(3);
+    assert(vector.size() == 199);
+    assert(vector.find(3) == -1);
+    assert(vector.at(3) == 4);
+
+    while (!vector.is_empty())
+        vector.pop();
+    assert(vector.capacity() == 256);
+
+    bool threw = false;
+    try
+    {
+        vector.at(0);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* Non trivial items are constructed and destroyed exactly once */
+    ::orla::incremental_vector<std::string> strings(
+        [](const std::string& a, const std::string& b) { return a == b; });
+    for (int i = 0; i < 100; ++i)
+        strings.push(std::to_string(i));
+    for (int i = 99; i >= 50; --i)
+        assert(strings.pop() == std::to_string(i));
+    assert(strings.at(42) == "42");
+    assert(strings.find("7") == 7);
+}
+
+template <class Allocator>
+void check_huge_page_vector()
+{
+    /* A 4 KiB threshold so the test crosses into mapped storage quickly */
+    ::orla::vector<int, Allocator> vector(int_comparator);
+    assert(!Allocator::is_mapped(vector.capacity()));
+
+    for (int i = 0; i < 1 << 20; ++i)
+        vector.push(i);
+    assert(Allocator::is_mapped(vector.capacity()));
+    assert(reinterpret_cast<uintptr_t>(vector.data()) % ::orla::huge_page_size == 0);
+
+    for (int i = 0; i < 1 << 20; i += 4099)
+        assert(vector.at(i) == i);
+
+    vector.insert(1, -1);
+    assert(vector.at(1) == -1);
+    vector.erase_at(1);
+
+    while (vector.size() > 100)
+        vector.pop();
+    assert(!Allocator::is_mapped(vector.capacity()));
+    for (int i = 0; i < 100; ++i)
+        assert(vector.at(i) == i);
+}
+
+void test_huge_page_allocator()
+{
+    check_huge_page_vector<::orla::huge_page_allocator<int, ::orla::numa_policy::none, 4096>>();
+    check_huge_page_vector<::orla::huge_page_allocator<int, ::orla::numa_policy::interleave, 4096>>();
+    check_huge_page_vector<::orla::huge_page_allocator<int, ::orla::numa_policy::first_touch, 4096>>();
+
+    uint64_t nodes = ::orla::detail::online_numa_nodes();
+    assert(!nodes || (nodes & 1));
+
+    typedef ::orla::huge_page_allocator<long long> allocator;
+    ::orla::vector<long long, allocator> large(long_long_comparator);
+    long long* values = large.extend(1 << 19);
+    assert(allocator::is_mapped(large.capacity()));
+    assert(reinterpret_cast<uintptr_t>(values) % ::orla::huge_page_size == 0);
+    for (size_t i = 0; i < large.size(); ++i)
+        assert(values[i] == 0);
+
+    assert(::orla::parallel::count_if(large, [](long long v) { return v == 0; }) == large.size());
+
+    /* Growing through mremap keeps the huge page alignment */
+    large.push(1);
+    assert(large.capacity() == 1 << 20);
+    assert(reinterpret_cast<uintptr_t>(large.data()) % ::orla::huge_page_size == 0);
+    assert(large.at(1 << 19) == 1 && large.at((1 << 19) - 1) == 0);
+}
+
+void test_snapshot()
+{
+    char path[] = "/tmp/orla_snapshot_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+
+    ::orla::vector<long long> numbers(long_long_comparator);
+    for (long long i = 0; i < 10000; ++i)
+        numbers.push(i * i);
+
+    ::orla::write_snapshot(fd, numbers);
+    assert(lseek(fd, 0, SEEK_END) ==
+           static_cast<off_t>(::orla::snapshot_header_size + 10000 * sizeof(long long) + ::orla::snapshot_trailer_size));
+
+    /* Loading appends to whatever the vector already holds */
+    ::orla::vector<long long> loaded(long_long_comparator);
+    loaded.push(-1);
+    lseek(fd, 0, SEEK_SET);
+    ::orla::read_snapshot(fd, loaded);
+    assert(loaded.size() == 10001);
+    assert(loaded.at(0) == -1);
+    for (long long i = 0; i < 10000; ++i)
+        assert(loaded.at(i + 1) == i * i);
+
+    {
+        ::orla::snapshot_view<long long> view(path);
+        assert(view.size() == 10000);
+        assert(view.at(100) == 10000);
+        assert(view.verify());
+
+        long long sum = 0;
+        for (long long value : view)
+            sum += value;
+        assert(sum == 333283335000LL);
+    }
+
+    /* A flipped payload byte is caught by the checksum */
+    long long corrupt = 7;
+    assert(pwrite(fd, &corrupt, sizeof(corrupt), ::orla::snapshot_header_size + 5 * sizeof(long long)) == sizeof(corrupt));
+    {
+        ::orla::snapshot_view<long long> view(path);
+        assert(!view.verify());
+    }
+
+    bool threw = false;
+    try
+    {
+        ::orla::vector<long long> rejected(long_long_comparator);
+        lseek(fd, 0, SEEK_SET);
+        ::orla::read_snapshot(fd, rejected);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try
+    {
+        ::orla::vector<int> wrong_type(int_comparator);
+        lseek(fd, 0, SEEK_SET);
+        ::orla::read_snapshot(fd, wrong_type);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* Lists stream in chunks, 10 items per chunk exercises the partial last one */
+    ::orla::doubly_linked_list<int> doubly(int_comparator);
+    for (int i = 0; i < 95; ++i)
+        doubly.push_back(i * 3);
+
+    assert(ftruncate(fd, 0) == 0);
+    lseek(fd, 0, SEEK_SET);
+    ::orla::write_snapshot(fd, doubly, 10);
+
+    ::orla::singly_linked_list<int> singly(int_comparator);
+    ::orla::doubly_linked_list<int> reloaded(int_comparator);
+    lseek(fd, 0, SEEK_SET);
+    ::orla::read_snapshot(fd, singly, 7);
+    lseek(fd, 0, SEEK_SET);
+    ::orla::read_snapshot(fd, reloaded);
+    assert(singly.size() == 95);
+    assert(reloaded.size() == 95);
+    for (int i = 0; i < 95; ++i)
+    {
+        assert(singly.value_at(i) == i * 3);
+        assert(reloaded.value_at(i) == i * 3);
+    }
+    assert(reloaded.average_stride() == ::orla::doubly_linked_list<int>::node_stride());
+
+    /* A checksum mismatch leaves the list as it was */
+    int flipped = -1;
+    assert(pwrite(fd, &flipped, sizeof(flipped), ::orla::snapshot_header_size + 50 * sizeof(int)) == sizeof(flipped));
+    threw = false;
+    try
+    {
+        lseek(fd, 0, SEEK_SET);
+        ::orla::read_snapshot(fd, reloaded);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw && reloaded.size() == 95);
+    assert(reloaded.back() == 94 * 3);
+
+    /* Truncated streams are rejected without keeping the items read so far */
+    assert(ftruncate(fd, ::orla::snapshot_header_size + 40) == 0);
+    threw = false;
+    try
+    {
+        lseek(fd, 0, SEEK_SET);
+        ::orla::read_snapshot(fd, singly, 7);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw && singly.size() == 95);
+    singly.push_back(-1);
+    assert(singly.value_at(94) == 94 * 3);
+    assert(singly.back() == -1);
+
+    /* Lists truncate from any size, an empty one stays usable */
+    reloaded.truncate(10);
+    assert(reloaded.size() == 10 && reloaded.back() == 27);
+    reloaded.truncate(0);
+    assert(reloaded.is_empty());
+    reloaded.push_back(5);
+    assert(reloaded.front() == 5 && reloaded.back() == 5);
+    singly.truncate(0);
+    singly.push_back(6);
+    assert(singly.front() == 6 && singly.back() == 6);
+
+    /* Hostile counts are rejected before anything is allocated, the vector keeps its size */
+    ::orla::snapshot_header hostile  = ::orla::detail::make_snapshot_header<long long>(0);
+    uint64_t                counts[] = { ~0ULL, 1ULL << 40, 6 };
+    for (uint64_t count : counts)
+    {
+        hostile.count = count;
+        assert(ftruncate(fd, 0) == 0);
+        assert(pwrite(fd, &hostile, sizeof(hostile), 0) == sizeof(hostile));
+        assert(pwrite(fd, &corrupt, sizeof(corrupt), sizeof(hostile)) == sizeof(corrupt));
+
+        threw = false;
+        try
+        {
+            lseek(fd, 0, SEEK_SET);
+            ::orla::read_snapshot(fd, loaded);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        assert(threw && loaded.size() == 10001);
+
+        threw = false;
+        try
+        {
+            ::orla::doubly_linked_list<long long> list(long_long_comparator);
+            lseek(fd, 0, SEEK_SET);
+            ::orla::read_snapshot(fd, list);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        assert(threw);
+
+        threw = false;
+        try
+        {
+            ::orla::snapshot_view<long long> view(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        assert(threw);
+    }
+
+    /* Streams grow the vector as items arrive and truncate it back when they end early */
+    int pipe_fds[2];
+    assert(pipe(pipe_fds) == 0);
+    hostile.count = 1000;
+    assert(write(pipe_fds[1], &hostile, sizeof(hostile)) == sizeof(hostile));
+    assert(write(pipe_fds[1], numbers.data(), 10 * sizeof(long long)) == 10 * sizeof(long long));
+    close(pipe_fds[1]);
+
+    threw = false;
+    try
+    {
+        ::orla::read_snapshot(pipe_fds[0], loaded);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    assert(threw && loaded.size() == 10001);
+    close(pipe_fds[0]);
+
+    assert(pipe(pipe_fds) == 0);
+    ::orla::vector<long long> few(long_long_comparator);
+    for (long long i = 0; i < 10; ++i)
+        few.push(i);
+    ::orla::write_snapshot(pipe_fds[1], few);
+    close(pipe_fds[1]);
+    ::orla::read_snapshot(pipe_fds[0], loaded);
+    assert(loaded.size() == 10011 && loaded.at(10010) == 9);
+    close(pipe_fds[0]);
+
+    close(fd);
+    unlink(path);
+}
+
+void test_stats()
+{
+    /* Disabled stats take no space and report zeros */
+    static_assert(std::is_empty<::orla::null_stats>::value, "null_stats must be empty");
+    static_assert(sizeof(::orla::vector<int>) ==
+                      sizeof(::orla::vector<int, ::orla::default_allocator<int>, ::orla::counting_stats>) -
+                          sizeof(::orla::container_stats),
+                  "null_stats must be compiled out");
+
+    ::orla::vector<int> plain(int_comparator);
+    plain.push(1);
+    assert(plain.stats().allocations == 0);
+
+    ::orla::counting_stats::reset_global_stats();
+
+    ::orla::vector<int, ::orla::default_allocator<int>, ::orla::counting_stats> vector(int_comparator);
+    assert(vector.stats().allocations == 1);
+    assert(vector.stats().bytes_allocated == 16 * sizeof(int));
+
+    for (int i = 0; i < 17; ++i)
+        vector.push(i);
+    ::orla::container_stats vector_stats = vector.stats();
+    assert(vector_stats.resizes == 1);
+    assert(vector_stats.allocations == 2);
+    assert(vector_stats.bytes_allocated == 48 * sizeof(int));
+    assert(vector_stats.elements_moved == 16);
+
+    vector.insert(7, 100);
+    assert(vector.stats().elements_moved == 16 + 10);
+    vector.erase_at(0);
+    assert(vector.stats().elements_moved == 16 + 10 + 17);
+    assert(vector.find(100) == 6);
+    assert(vector.stats().comparisons == 7);
+    assert(vector.find(-5) == -1);
+    assert(vector.stats().comparisons == 7 + 17);
+
+    ::orla::singly_linked_list<int, ::orla::counting_stats> singly(int_comparator);
+    ::orla::doubly_linked_list<int, ::orla::counting_stats> doubly(int_comparator);
+    for (int i = 0; i < 10; ++i)
+    {
+        singly.push_back(i);
+        doubly.push_back(i);
+    }
+    assert(singly.stats().allocations == 10);
+    assert(doubly.stats().allocations == 10);
+
+    assert(singly.value_at(6) == 6);
+    assert(doubly.value_at(6) == 6);
+    assert(singly.stats().node_hops == 6);
+    assert(doubly.stats().node_hops == 6);
+
+    singly.remove_value(3);
+    doubly.remove_value(3);
+    assert(singly.stats().comparisons == 4);
+    assert(doubly.stats().comparisons == 4);
+    assert(doubly.stats().node_hops == 6 + 4);
+
+    size_t indices[] = { 1, 7 };
+    assert(singly.erase_many(indices, 2) == 2);
+    assert(singly.stats().node_hops == 6 + 4 + 6);
+
+    doubly.relayout();
+    assert(doubly.stats().elements_moved == 9);
+    assert(doubly.stats().allocations == 11);
+
+    /* Process wide counters aggregate every counting container */
+    ::orla::container_stats global = ::orla::counting_stats::global_stats();
+    assert(global.allocations == vector.stats().allocations + singly.stats().allocations + doubly.stats().allocations);
+    assert(global.node_hops == singly.stats().node_hops + doubly.stats().node_hops);
+    assert(global.comparisons == vector.stats().comparisons + 8);
+
+    vector.reset_stats();
+    assert(vector.stats().comparisons == 0);
+    assert(::orla::counting_stats::global_stats().comparisons == global.comparisons);
+
+    char  buffer[256];
+    FILE* out = fmemopen(buffer, sizeof(buffer), "w");
+    ::orla::dump_stats(out, "doubly", doubly.stats());
+    fclose(out);
+    assert(std::string(buffer).find("doubly: allocations=11 ") == 0);
+}
+
+template <class List>
+void check_list_access(List& list)
+{
+    int* item = nullptr;
+    int  value;
+    assert(list.try_value_at(0, &item) == ::orla::access_error::out_of_range);
+    assert(list.try_pop_front(&value) == ::orla::access_error::empty);
+    assert(list.try_pop_back(&value) == ::orla::access_error::empty);
+
+    for (int i = 0; i < 5; ++i)
+        list.push_back(i);
+
+    assert(list.front_unchecked() == 0);
+    assert(list.back_unchecked() == 4);
+    assert(list.try_value_at(3, &item) == ::orla::access_error::none && *item == 3);
+    assert(list.try_value_at(5, &item) == ::orla::access_error::out_of_range && *item == 3);
+
+    assert(list.try_pop_front(&value) == ::orla::access_error::none && value == 0);
+    assert(list.try_pop_back(&value) == ::orla::access_error::none && value == 4);
+    assert(list.pop_front_unchecked() == 1);
+    assert(list.pop_back_unchecked() == 3);
+    assert(list.size() == 1 && list.front() == 2 && list.back() == 2);
+}
+
+void test_bounds()
+{
+    ::orla::vector<int> checked(int_comparator);
+    for (int i = 0; i < 20; ++i)
+        checked.push(i);
+
+    assert(checked[7] == 7);
+    checked[7] = 70;
+    assert(checked.at(7) == 70);
+
+    int* item = nullptr;
+    assert(checked.try_at(19, &item) == ::orla::access_error::none && *item == 19);
+    assert(checked.try_at(20, &item) == ::orla::access_error::out_of_range && *item == 19);
+    assert(checked.pop_unchecked() == 19);
+
+    int value = 0;
+    while (checked.try_pop(&value) == ::orla::access_error::none)
+        ;
+    assert(value == 0 && checked.is_empty());
+    assert(checked.try_pop(&value) == ::orla::access_error::empty);
+
+    bool threw = false;
+    try
+    {
+        checked.pop();
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* Unchecked containers keep the same behaviour on valid input */
+    ::orla::vector<int, ::orla::default_allocator<int>, ::orla::null_stats, ::orla::unchecked_bounds> unchecked(
+        int_comparator);
+    for (int i = 0; i < 20; ++i)
+        unchecked.insert(unchecked.size(), i);
+    unchecked.erase_at(0);
+    assert(unchecked.at(0) == 1 && unchecked.pop() == 19 && unchecked.size() == 18);
+
+    ::orla::doubly_linked_list<int, ::orla::null_stats, ::orla::debug_bounds> debug(int_comparator);
+    debug.push_back(1);
+    debug.insert(0, 0);
+    debug.erase(1);
+    assert(debug.value_at(0) == 0 && debug.pop_back() == 0);
+
+    ::orla::singly_linked_list<int> singly(int_comparator);
+    ::orla::doubly_linked_list<int> doubly(int_comparator);
+    check_list_access(singly);
+    check_list_access(doubly);
+
+    ::orla::singly_linked_list<int, ::orla::null_stats, ::orla::unchecked_bounds> unchecked_singly(int_comparator);
+    ::orla::doubly_linked_list<int, ::orla::null_stats, ::orla::unchecked_bounds> unchecked_doubly(int_comparator);
+    check_list_access(unchecked_singly);
+    check_list_access(unchecked_doubly);
+}
+
+void test_priority_queue()
+{
+    ::orla::priority_queue<int> queue;
+    assert(queue.is_empty());
+
+    bool threw = false;
+    try
+    {
+        queue.pop();
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* Pseudo random keys come out sorted */
+    unsigned int seed = 7;
+    for (int i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        queue.push(static_cast<int>((seed >> 8) % 500));
+    }
+    assert(queue.size() == 1000);
+
+    int previous = queue.pop();
+    while (!queue.is_empty())
+    {
+        int current = queue.pop();
+        assert(previous <= current);
+        previous = current;
+    }
+
+    /* Handles follow their items through update, decrease_key and erase */
+    ::orla::priority_queue<int>::handle handles[100];
+    for (int i = 0; i < 100; ++i)
+        handles[i] = queue.push(1000 + i);
+
+    queue.decrease_key(handles[60], 5);
+    assert(queue.top() == 5 && queue.top_handle() == handles[60]);
+    queue.update(handles[60], 5000);
+    assert(queue.top() == 1000 && queue.value_of(handles[60]) == 5000);
+    queue.update(handles[99], 1);
+    assert(queue.top_handle() == handles[99]);
+
+    threw = false;
+    try
+    {
+        queue.decrease_key(handles[10], 2000);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    queue.erase(handles[99]);
+    queue.erase(handles[0]);
+    assert(!queue.contains(handles[0]) && queue.size() == 98);
+    assert(queue.pop() == 1001);
+    assert(queue.value_of(handles[50]) == 1050);
+
+    /* Bulk build into a max heap with eight children per item */
+    int items[] = { 4, 9, 1, 7, 3, 8, 2, 6, 5, 0, 11, 10 };
+    ::orla::priority_queue<int, std::greater<int>, 8>::handle built[12];
+    ::orla::priority_queue<int, std::greater<int>, 8>         max_queue;
+    max_queue.push(100);
+    max_queue.make_heap(items, items + 12, built);
+    assert(max_queue.size() == 12);
+    assert(max_queue.value_of(built[10]) == 11);
+
+    max_queue.update(built[2], 20);
+    for (int expected : { 20, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2 })
+        assert(max_queue.pop() == expected);
+    assert(max_queue.size() == 1 && max_queue.top() == 0);
+
+    queue.clear();
+    assert(queue.is_empty());
+    queue.make_heap(items, items);
+    assert(queue.is_empty());
+
+    void* line = ::orla::cache_aligned_allocator<long>::allocate(3);
+    assert(reinterpret_cast<uintptr_t>(line) % ::orla::cache_line_size == 0);
+    ::orla::cache_aligned_allocator<long>::deallocate(static_cast<long*>(line), 3);
+}
+
+void test_external_sort()
+{
+    /* Small runs and blocks force many spills and refills, a fan-in of 8 two merge passes */
+    ::orla::external_sort_options options;
+    options.run_items   = 100;
+    options.block_bytes = 16 * sizeof(int);
+    options.max_fan_in  = 8;
+
+    ::orla::external_sorter<int> sorter(options);
+    unsigned int                 seed = 11;
+    long long                    sum  = 0;
+    for (int i = 0; i < 10050; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        int item = static_cast<int>((seed >> 8) % 100000);
+        sum += item;
+        sorter.push(item);
+    }
+    assert(sorter.size() == 10050 && sorter.run_count() == 100);
+    assert(sorter.run_count() > options.max_fan_in);
+
+    int  item     = 0;
+    int  previous = -1;
+    long count    = 0;
+    while (sorter.next(item))
+    {
+        assert(previous <= item);
+        previous = item;
+        sum -= item;
+        count++;
+    }
+    assert(count == 10050 && sum == 0 && sorter.run_count() == 2);
+    assert(!sorter.next(item));
+
+    bool threw = false;
+    try
+    {
+        sorter.push(1);
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* List contents that fit one run are sorted without touching disk */
+    ::orla::doubly_linked_list<int> list(int_comparator);
+    for (int i = 0; i < 50; ++i)
+        list.push_back((i * 37) % 50);
+
+    ::orla::external_sorter<int, std::greater<int>> in_memory;
+    in_memory.push(list.begin(), list.end());
+    for (int expected = 49; expected >= 0; --expected)
+        assert(in_memory.next(item) && item == expected);
+    assert(!in_memory.next(item) && in_memory.run_count() == 0);
+
+    threw = false;
+    try
+    {
+        options.max_fan_in = 1;
+        ::orla::external_sorter<int> single(options);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+    options.max_fan_in = 8;
+
+    /* Merged output lands in a file backed vector */
+    char path[] = "/tmp/orla_external_sort_XXXXXX";
+    int  fd     = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    options.run_items = 7;
+    ::orla::external_sorter<int> to_file(options);
+    for (int i = 0; i < 100; ++i)
+        to_file.push(99 - i);
+
+    {
+        ::orla::mmap_vector<int> out(path, int_comparator, ::orla::mmap_open_mode::create);
+        to_file.write_to(out);
+        assert(out.size() == 100);
+        for (int i = 0; i < 100; ++i)
+            assert(out.at(i) == i);
+    }
+    unlink(path);
+}
+
+template <class Vector>
+bool persistent_vector_matches(Vector& vector, const int* model, const size_t size)
+{
+    if (vector.size() != size)
+        return false;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (vector.at(i) != model[i])
+            return false;
+    }
+
+    return true;
+}
+
+void test_persistent_vector()
+{
+    static int model[12000];
+    size_t     size = 0;
+
+    ::orla::persistent_vector<int> vector(int_comparator);
+    assert(vector.is_empty());
+
+    /* Pushes past three tree levels, snapshots stay frozen */
+    for (int i = 0; i < 5000; ++i)
+    {
+        vector.push(i);
+        model[size++] = i;
+    }
+    ::orla::persistent_vector<int> frozen = vector.snapshot();
+    assert(persistent_vector_matches(vector, model, size));
+
+    for (int i = 0; i < 100; ++i)
+        assert(vector.pop() == model[--size]);
+    vector.set(10, -10);
+    vector.set(4850, -4850);
+    model[10]   = -10;
+    model[4850] = -4850;
+    assert(persistent_vector_matches(vector, model, size));
+    assert(frozen.size() == 5000 && frozen.at(10) == 10 && frozen.at(4999) == 4999);
+    assert(vector.find(-4850) == 4850 && frozen.find(-4850) == -1);
+
+    /* Random inserts and erases through split and concatenation */
+    unsigned int seed = 3;
+    for (int round = 0; round < 3000; ++round)
+    {
+        seed         = seed * 1103515245 + 12345;
+        size_t index = (seed >> 8) % (size + 1);
+        if (round % 3 == 2 && size)
+        {
+            index %= size;
+            vector.erase_at(index);
+            for (size_t i = index; i + 1 < size; ++i)
+                model[i] = model[i + 1];
+            size--;
+        }
+        else
+        {
+            vector.insert(index, 100000 + round);
+            for (size_t i = size; i > index; --i)
+                model[i] = model[i - 1];
+            model[index] = 100000 + round;
+            size++;
+        }
+
+        if (round % 500 == 0)
+            assert(persistent_vector_matches(vector, model, size));
+    }
+    assert(persistent_vector_matches(vector, model, size));
+    assert(frozen.size() == 5000 && frozen.at(2500) == 2500);
+
+    /* Concatenation of vectors of different heights, both kept usable */
+    ::orla::persistent_vector<int> small(int_comparator);
+    for (int i = 0; i < 40; ++i)
+        small.push(-i);
+
+    ::orla::persistent_vector<int> joined = small;
+    joined.append(vector);
+    joined.append(small);
+    assert(joined.size() == size + 80);
+    assert(joined.at(39) == -39 && joined.at(40) == model[0] && joined.at(size + 40) == 0);
+    for (size_t i = 0; i < size; ++i)
+        assert(joined.at(i + 40) == model[i]);
+    assert(small.size() == 40 && persistent_vector_matches(vector, model, size));
+
+    while (!joined.is_empty())
+        joined.pop();
+    joined.push(1);
+    assert(joined.size() == 1 && joined.at(0) == 1);
+
+    /* A reader thread walks a snapshot while the writer keeps mutating */
+    ::orla::persistent_vector<int> reader_view = vector.snapshot();
+    std::thread reader([&reader_view, size]() {
+        for (size_t i = 0; i < size; ++i)
+            assert(reader_view.at(i) == model[i]);
+    });
+    for (int i = 0; i < 2000; ++i)
+        vector.insert(i * 3 % (vector.size() + 1), i);
+    reader.join();
+
+    bool threw = false;
+    try
+    {
+        frozen.at(5000);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+template <size_t Bits>
+void check_packed_vector(const uint64_t modulo)
+{
+    ::orla::packed_vector<Bits> vector;
+    for (uint64_t i = 0; i < 300; ++i)
+        vector.push(i * 2654435761ULL % modulo);
+    assert(vector.size() == 300);
+    assert(vector.bytes() == (300 * Bits + 63) / 64 * sizeof(uint64_t));
+
+    for (uint64_t i = 0; i < 300; ++i)
+        assert(vector.at(i) == i * 2654435761ULL % modulo);
+
+    /* Unaligned head and tail around four aligned groups of 64 */
+    uint64_t decoded[300];
+    vector.decode(5, 290, decoded);
+    for (uint64_t i = 0; i < 290; ++i)
+        assert(decoded[i] == (i + 5) * 2654435761ULL % modulo);
+
+    vector.set(77, modulo - 1);
+    assert(vector.at(76) == 76 * 2654435761ULL % modulo);
+    assert(vector.at(77) == modulo - 1);
+    assert(vector.at(78) == 78 * 2654435761ULL % modulo);
+
+    assert(vector.pop() == 299 * 2654435761ULL % modulo);
+    assert(vector.size() == 299);
+}
+
+void test_packed_vector()
+{
+    check_packed_vector<3>(8);
+    check_packed_vector<17>(1 << 17);
+    check_packed_vector<64>(~0ULL);
+
+    ::orla::packed_vector<5> narrow;
+    bool threw = false;
+    try
+    {
+        narrow.push(32);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw && narrow.is_empty());
+
+    uint32_t small[64];
+    for (uint32_t i = 0; i < 64; ++i)
+        narrow.push(i % 32);
+    narrow.decode(0, 64, small);
+    assert(small[0] == 0 && small[31] == 31 && small[63] == 31);
+
+    /* Sorted ids with small gaps and duplicates */
+    ::orla::sorted_id_vector ids;
+    uint64_t                 expected[1000];
+    uint64_t                 id   = 1000000;
+    unsigned int             seed = 5;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        id += (seed >> 8) % 16;
+        expected[i] = id;
+        ids.push(id);
+    }
+    assert(ids.size() == 1000);
+    assert(ids.bytes() * 4 < 1000 * sizeof(uint64_t));
+
+    for (size_t i = 0; i < 1000; ++i)
+        assert(ids.at(i) == expected[i]);
+
+    uint64_t decoded[1000];
+    ids.decode(100, 850, decoded);
+    for (size_t i = 0; i < 850; ++i)
+        assert(decoded[i] == expected[i + 100]);
+
+    for (size_t i = 0; i < 1000; i += 7)
+    {
+        int found = ids.find(expected[i]);
+        assert(found >= 0 && ids.at(found) == expected[i] && (!found || ids.at(found - 1) < expected[i]));
+        size_t after = std::upper_bound(expected, expected + 1000, expected[i]) - expected;
+        assert(ids.lower_bound(expected[i] + 1) == after);
+    }
+    assert(ids.find(999999) == -1 && ids.lower_bound(0) == 0);
+    assert(ids.find(expected[999] + 1) == -1 && ids.lower_bound(expected[999] + 1) == 1000);
+
+    threw = false;
+    try
+    {
+        ids.push(5);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+void test_bit_vector()
+{
+    /* Random inserts and erases against a model array of bools */
+    ::orla::bit_vector bits;
+    bool               model[3000];
+    size_t             size = 0;
+    unsigned int       seed = 9;
+    for (size_t i = 0; i < 4000; ++i)
+    {
+        seed         = seed * 1103515245 + 12345;
+        size_t where = (seed >> 8) % (size + 1);
+        bool   value = (seed >> 20) & 1;
+        if (size && (size == 3000 || (seed >> 24) % 3 == 0))
+        {
+            where %= size;
+            bits.erase_at(where);
+            std::copy(model + where + 1, model + size, model + where);
+            size--;
+        }
+        else
+        {
+            bits.insert(where, value);
+            std::copy_backward(model + where, model + size, model + size + 1);
+            model[where] = value;
+            size++;
+        }
+    }
+    assert(bits.size() == size && size > 1000);
+    assert(bits.bytes() == (size + 63) / 64 * sizeof(uint64_t));
+
+    size_t set = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        assert(bits.at(i) == model[i]);
+        set += model[i];
+    }
+    assert(bits.count() == set);
+
+    size_t next = bits.find_first_set();
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (!model[i])
+            continue;
+        assert(next == i);
+        next = bits.find_next_set(i);
+    }
+    assert(next == size);
+
+    /* rank() and select() agree with and without the index */
+    size_t scanned[3000];
+    for (size_t i = 0; i <= size; i += 13)
+        scanned[i] = bits.rank(i);
+    bits.build_rank_index();
+    assert(bits.has_rank_index() && bits.count() == set);
+    for (size_t i = 0, before = 0; i <= size; ++i)
+    {
+        assert(bits.rank(i) == before);
+        if (!(i % 13))
+            assert(scanned[i] == before);
+        if (i < size && model[i])
+            assert(bits.select(before++) == i);
+    }
+    assert(bits.select(set) == size);
+
+    bits.set(0, !model[0]);
+    assert(!bits.has_rank_index());
+    assert(bits.rank(size) == set + (model[0] ? -1 : 1));
+    bits.set(0, model[0]);
+
+    /* Word parallel logical operations */
+    ::orla::bit_vector mask;
+    for (size_t i = 0; i < size; ++i)
+        mask.push(i % 3 == 0);
+
+    ::orla::bit_vector result;
+    for (size_t i = 0; i < size; ++i)
+        result.push(model[i]);
+    result.and_with(mask);
+    for (size_t i = 0; i < size; ++i)
+        assert(result.at(i) == (model[i] && i % 3 == 0));
+    result.or_with(bits);
+    for (size_t i = 0; i < size; ++i)
+        assert(result.at(i) == model[i]);
+    result.xor_with(mask);
+    for (size_t i = 0; i < size; ++i)
+        assert(result.at(i) == (model[i] != (i % 3 == 0)));
+    result.and_not_with(bits);
+    for (size_t i = 0; i < size; ++i)
+        assert(result.at(i) == (!model[i] && i % 3 == 0));
+
+    bool threw = false;
+    mask.push(true);
+    try
+    {
+        result.and_with(mask);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    /* Sparse bits take select() across empty superblocks */
+    ::orla::bit_vector sparse;
+    for (size_t i = 0; i < 100000; ++i)
+        sparse.push(i % 7919 == 5);
+    sparse.build_rank_index();
+    for (size_t n = 0; n < sparse.count(); ++n)
+        assert(sparse.select(n) == n * 7919 + 5);
+    assert(sparse.rank(100000) == sparse.count());
+
+    while (!sparse.is_empty())
+        sparse.pop();
+    assert(sparse.bytes() == 0 && sparse.find_first_set() == 0);
+
+    threw = false;
+    try
+    {
+        sparse.pop();
+    }
+    catch (const std::logic_error&)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
 int main()
 {
     test_vector();
     test_doubly_linked_list();
+    test_doubly_linked_list_relayout();
+    test_doubly_linked_list_handles();
     test_singly_linked_list();
+    test_list_batched_access();
+    test_parallel();
+    test_soa_vector();
+    test_static_vector();
+    test_mmap_vector();
+    test_unrolled_list();
+    test_compact_list();
+    test_lru_cache();
+    test_views();
+    test_incremental_vector();
+    test_huge_page_allocator();
+    test_snapshot();
+    test_stats();
+    test_bounds();
+    test_priority_queue();
+    test_external_sort();
+    test_persistent_vector();
+    test_packed_vector();
+    test_bit_vector();
     printf("Success!\n");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <thread>
+#include "channel.hpp"
+
+bool int_comparator(const int& a, const int& b)
+{
+    return a == b;
+}
+
+::orla::task produce(::orla::channel<int>& ch, int first, int count, bool close_when_done)
+{
+    for (int i = first; i < first + count; ++i)
+    {
+        bool sent = co_await ch.send(i);
+        if (!sent)
+            break;
+    }
+
+    if (close_when_done)
+        ch.close();
+}
+
+::orla::task consume(::orla::channel<int>& ch, ::orla::vector<int>& out)
+{
+    for (;;)
+    {
+        std::optional<int> item = co_await ch.receive();
+        if (!item)
+            break;
+        out.push(*item);
+    }
+}
+
+::orla::task consume_batches(::orla::channel<int>& ch, ::orla::vector<int>& out, size_t& batches)
+{
+    for (;;)
+    {
+        size_t received = co_await ch.receive_batch(out, 4);
+        if (!received)
+            break;
+        batches++;
+    }
+}
+
+::orla::task send_after_close(::orla::channel<int>& ch, bool& result)
+{
+    result = co_await ch.send(1);
+}
+
+::orla::task sum_all(::orla::channel<int>& ch, std::atomic<long>& sum)
+{
+    for (;;)
+    {
+        std::optional<int> item = co_await ch.receive();
+        if (!item)
+            break;
+        sum += *item;
+    }
+}
+
+::orla::task produce_and_count(::orla::channel<int>& ch, int count, std::atomic<int>& producers_left)
+{
+    for (int i = 1; i <= count; ++i)
+        co_await ch.send(i);
+
+    if (--producers_left == 0)
+        ch.close();
+}
+
+void test_channel()
+{
+    /* single producer/consumer keeps order through a small buffer */
+    {
+        ::orla::single_thread_scheduler sched;
+        ::orla::channel<int>            ch(2);
+        ::orla::vector<int>             out(int_comparator);
+
+        sched.spawn(consume(ch, out));
+        sched.spawn(produce(ch, 0, 100, true));
+        sched.run();
+
+        assert(sched.pending_tasks() == 0);
+        assert(out.size() == 100);
+        for (size_t i = 0; i < out.size(); ++i)
+            assert(out.at(i) == (int)i);
+        assert(ch.is_closed());
+        assert(ch.size() == 0);
+    }
+
+    /* rendezvous channel */
+    {
+        ::orla::single_thread_scheduler sched;
+        ::orla::channel<int>            ch(0);
+        ::orla::vector<int>             out(int_comparator);
+
+        sched.spawn(produce(ch, 10, 5, true));
+        sched.spawn(consume(ch, out));
+        sched.run();
+
+        assert(out.size() == 5);
+        assert(out.at(0) == 10);
+        assert(out.at(4) == 14);
+    }
+
+    /* batch receive drains whatever is buffered */
+    {
+        ::orla::single_thread_scheduler sched;
+        ::orla::channel<int>            ch(8);
+        ::orla::vector<int>             out(int_comparator);
+        size_t                          batches = 0;
+
+        sched.spawn(produce(ch, 0, 10, true));
+        sched.spawn(consume_batches(ch, out, batches));
+        sched.run();
+
+        assert(out.size() == 10);
+        assert(batches == 4);
+        for (size_t i = 0; i < out.size(); ++i)
+            assert(out.at(i) == (int)i);
+    }
+
+    /* blocked tasks stay parked, close wakes them */
+    {
+        ::orla::single_thread_scheduler sched;
+        ::orla::channel<int>            ch(1);
+        ::orla::vector<int>             out(int_comparator);
+        bool                            result = true;
+
+        sched.spawn(produce(ch, 0, 3, false));
+        sched.run();
+        assert(sched.pending_tasks() == 1);
+        assert(ch.size() == 1);
+
+        ch.close();
+        sched.run();
+        assert(sched.pending_tasks() == 0);
+
+        sched.spawn(send_after_close(ch, result));
+        sched.spawn(consume(ch, out));
+        sched.run();
+        assert(!result);
+        assert(out.size() == 1);
+        assert(out.at(0) == 0);
+    }
+
+    /* many producers and consumers across a thread pool */
+    {
+        ::orla::thread_pool_scheduler sched(4);
+        ::orla::channel<int>          ch(16);
+        std::atomic<long>             sum{ 0 };
+        std::atomic<int>              producers_left{ 8 };
+
+        for (int i = 0; i < 4; ++i)
+            sched.spawn(sum_all(ch, sum));
+        for (int i = 0; i < 8; ++i)
+            sched.spawn(produce_and_count(ch, 1000, producers_left));
+        sched.run();
+
+        assert(sched.pending_tasks() == 0);
+        assert(sum == 8 * 1000 * 1001 / 2);
+    }
+
+    /* pool workers wake a single thread task while its scheduler runs on another thread */
+    {
+        ::orla::single_thread_scheduler local;
+        ::orla::thread_pool_scheduler   pool(2);
+        ::orla::channel<int>            ch(4);
+        ::orla::vector<int>             out(int_comparator);
+        std::atomic<int>                producers_left{ 2 };
+
+        local.spawn(consume(ch, out));
+        pool.spawn(produce_and_count(ch, 500, producers_left));
+        pool.spawn(produce_and_count(ch, 500, producers_left));
+
+        std::thread runner([&local]() {
+            while (local.pending_tasks())
+                local.run();
+        });
+        while (pool.pending_tasks())
+            pool.run();
+        runner.join();
+
+        assert(out.size() == 1000);
+    }
+
+    /* destroying the channel posts its parked task back, the scheduler destroys the frame */
+    {
+        ::orla::single_thread_scheduler sched;
+        {
+            ::orla::channel<int> ch(0);
+            sched.spawn(produce(ch, 0, 1, false));
+            sched.run();
+            assert(sched.pending_tasks() == 1);
+        }
+    }
+}
+
+int main()
+{
+    test_channel();
+    printf("Success!\n");
+    return 0;
+}
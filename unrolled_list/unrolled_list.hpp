@@ -0,0 +1,443 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace orla
+{
+
+static const size_t unrolled_list_block_bytes = 64;
+
+/* Items fitting next to the block header in one cache line, but at least 4 */
+template <class T>
+constexpr size_t unrolled_list_default_block_size()
+{
+    return (unrolled_list_block_bytes - 3 * sizeof(void*)) / sizeof(T) > 4
+               ? (unrolled_list_block_bytes - 3 * sizeof(void*)) / sizeof(T)
+               : 4;
+}
+
+/**
+ * unrolled_list - doubly linked list of blocks holding up to BlockSize items
+ *
+ * Offers the singly/doubly_linked_list API while paying the link and
+ * allocation overhead once per block instead of once per item. A full block
+ * is split in two on insert, push_front() included, and an underfull block
+ * is merged with, or refilled from, its successor on erase. Every block but
+ * the last therefore stays at least half full; the last one is merged into
+ * its predecessor as soon as both fit in one block.
+ */
+template <class T, size_t BlockSize = unrolled_list_default_block_size<T>()>
+class unrolled_list
+{
+    static_assert(BlockSize >= 2, "unrolled_list blocks need room for at least two items");
+
+public:
+    typedef bool (*item_comparator)(const T& a, const T& b);
+
+    unrolled_list(item_comparator comparator);
+    unrolled_list(const unrolled_list& list) = delete;
+    ~unrolled_list();
+
+    size_t size();
+    size_t blocks();
+    bool   is_empty();
+    T&     value_at(const size_t index);
+    void   push_front(const T& value);
+    T      pop_front();
+    void   push_back(const T& value);
+    T      pop_back();
+    T&     front();
+    T&     back();
+    void   insert(const size_t index, const T& value);
+    void   erase(const size_t index);
+    T&     value_n_from_end(const size_t n);
+    void   reverse();
+    void   remove_value(const T& value);
+
+private:
+    /* data */
+    typedef struct block
+    {
+        block* next;
+        block* prev;
+        size_t count;
+        T      items[BlockSize];
+    } block_t;
+
+    size_t          m_size;
+    size_t          m_blocks;
+    block_t*        m_head;
+    block_t*        m_tail;
+    item_comparator m_comparator;
+
+    /* functions */
+    block_t* locate(size_t& index);
+    block_t* new_block_after(block_t* prev);
+    void     unlink_block(block_t* blk);
+    void     split(block_t* blk);
+    void     erase_in_block(block_t* blk, const size_t offset);
+    void     rebalance(block_t* blk);
+};
+
+template <class T, size_t BlockSize>
+unrolled_list<T, BlockSize>::unrolled_list(item_comparator comparator)
+    : m_size{ 0 }
+    , m_blocks{ 0 }
+    , m_head{ nullptr }
+    , m_tail{ nullptr }
+    , m_comparator{ comparator }
+{
+    if (!m_comparator)
+    {
+        throw std::invalid_argument("Comparator cannot be null");
+    }
+}
+
+template <class T, size_t BlockSize>
+unrolled_list<T, BlockSize>::~unrolled_list()
+{
+    block_t* del;
+    while (m_head)
+    {
+        del    = m_head;
+        m_head = m_head->next;
+        delete del;
+    }
+}
+
+template <class T, size_t BlockSize>
+size_t unrolled_list<T, BlockSize>::size()
+{
+    return m_size;
+}
+
+template <class T, size_t BlockSize>
+size_t unrolled_list<T, BlockSize>::blocks()
+{
+    return m_blocks;
+}
+
+template <class T, size_t BlockSize>
+bool unrolled_list<T, BlockSize>::is_empty()
+{
+    return !m_size;
+}
+
+template <class T, size_t BlockSize>
+T& unrolled_list<T, BlockSize>::value_at(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index");
+
+    size_t   offset = index;
+    block_t* blk    = locate(offset);
+    return blk->items[offset];
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::push_front(const T& value)
+{
+    if (!m_head)
+        new_block_after(nullptr);
+    else if (m_head->count == BlockSize)
+        split(m_head);
+
+    for (size_t i = m_head->count; i > 0; --i)
+        m_head->items[i] = m_head->items[i - 1];
+
+    m_head->items[0] = value;
+    m_head->count++;
+    m_size++;
+}
+
+template <class T, size_t BlockSize>
+T unrolled_list<T, BlockSize>::pop_front()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty list");
+
+    T ret = m_head->items[0];
+    erase_in_block(m_head, 0);
+    return ret;
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::push_back(const T& value)
+{
+    if (!m_tail || m_tail->count == BlockSize)
+        new_block_after(m_tail);
+
+    m_tail->items[m_tail->count] = value;
+    m_tail->count++;
+    m_size++;
+}
+
+template <class T, size_t BlockSize>
+T unrolled_list<T, BlockSize>::pop_back()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot pop from an empty list");
+
+    T ret = m_tail->items[m_tail->count - 1];
+    erase_in_block(m_tail, m_tail->count - 1);
+    return ret;
+}
+
+template <class T, size_t BlockSize>
+T& unrolled_list<T, BlockSize>::front()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot get front item from an empty list");
+
+    return m_head->items[0];
+}
+
+template <class T, size_t BlockSize>
+T& unrolled_list<T, BlockSize>::back()
+{
+    if (!m_size)
+        throw std::logic_error("Cannot get last item from an empty list");
+
+    return m_tail->items[m_tail->count - 1];
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::insert(const size_t index, const T& value)
+{
+    if (index > m_size)
+        throw std::out_of_range("Out of range index to insert item. Index should be <= size()");
+
+    if (index == m_size)
+    {
+        push_back(value);
+        return;
+    }
+
+    size_t   offset = index;
+    block_t* blk    = locate(offset);
+
+    if (blk->count == BlockSize)
+    {
+        split(blk);
+        if (offset > blk->count)
+        {
+            offset -= blk->count;
+            blk = blk->next;
+        }
+    }
+
+    for (size_t i = blk->count; i > offset; --i)
+        blk->items[i] = blk->items[i - 1];
+
+    blk->items[offset] = value;
+    blk->count++;
+    m_size++;
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::erase(const size_t index)
+{
+    if (index >= m_size)
+        throw std::out_of_range("Out of range index to erase");
+
+    size_t   offset = index;
+    block_t* blk    = locate(offset);
+    erase_in_block(blk, offset);
+}
+
+template <class T, size_t BlockSize>
+T& unrolled_list<T, BlockSize>::value_n_from_end(const size_t n)
+{
+    if (n >= m_size)
+        throw std::out_of_range("Out of range index to get value from end");
+
+    block_t* blk = m_tail;
+    size_t   from_end = n;
+    while (from_end >= blk->count)
+    {
+        from_end -= blk->count;
+        blk = blk->prev;
+    }
+
+    return blk->items[blk->count - 1 - from_end];
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::reverse()
+{
+    if (!m_size)
+        return;
+
+    block_t* blk;
+    for (blk = m_head; blk != nullptr; blk = blk->prev)
+    {
+        block_t* tmp = blk->prev;
+        blk->prev    = blk->next;
+        blk->next    = tmp;
+
+        for (size_t i = 0, j = blk->count - 1; i < j; ++i, --j)
+            std::swap(blk->items[i], blk->items[j]);
+    }
+
+    blk    = m_head;
+    m_head = m_tail;
+    m_tail = blk;
+
+    /* The old last block may be underfull and now leads the list */
+    rebalance(m_head);
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::remove_value(const T& value)
+{
+    for (block_t* blk = m_head; blk != nullptr; blk = blk->next)
+    {
+        for (size_t i = 0; i < blk->count; ++i)
+        {
+            if (m_comparator(value, blk->items[i]))
+            {
+                erase_in_block(blk, i);
+                return;
+            }
+        }
+    }
+}
+
+/* Returns the block holding index and turns index into an offset within it */
+template <class T, size_t BlockSize>
+typename unrolled_list<T, BlockSize>::block_t* unrolled_list<T, BlockSize>::locate(size_t& index)
+{
+    block_t* blk;
+    if (index < m_size / 2)
+    {
+        for (blk = m_head; index >= blk->count; blk = blk->next)
+            index -= blk->count;
+        return blk;
+    }
+
+    size_t from_end = m_size - 1 - index;
+    for (blk = m_tail; from_end >= blk->count; blk = blk->prev)
+        from_end -= blk->count;
+
+    index = blk->count - 1 - from_end;
+    return blk;
+}
+
+/* Links an empty block after prev, or at the front when prev is null */
+template <class T, size_t BlockSize>
+typename unrolled_list<T, BlockSize>::block_t* unrolled_list<T, BlockSize>::new_block_after(block_t* prev)
+{
+    block_t* blk = new block_t;
+    blk->count   = 0;
+    blk->prev    = prev;
+    blk->next    = prev ? prev->next : m_head;
+
+    if (blk->next)
+        blk->next->prev = blk;
+    else
+        m_tail = blk;
+
+    if (prev)
+        prev->next = blk;
+    else
+        m_head = blk;
+
+    m_blocks++;
+    return blk;
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::unlink_block(block_t* blk)
+{
+    if (blk->prev)
+        blk->prev->next = blk->next;
+    else
+        m_head = blk->next;
+
+    if (blk->next)
+        blk->next->prev = blk->prev;
+    else
+        m_tail = blk->prev;
+
+    delete blk;
+    m_blocks--;
+}
+
+/* Moves the upper half of a full block into a new successor */
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::split(block_t* blk)
+{
+    block_t* next = new_block_after(blk);
+    size_t   keep = blk->count / 2;
+
+    for (size_t i = keep; i < blk->count; ++i)
+        next->items[i - keep] = blk->items[i];
+
+    next->count = blk->count - keep;
+    blk->count  = keep;
+}
+
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::erase_in_block(block_t* blk, const size_t offset)
+{
+    for (size_t i = offset; i + 1 < blk->count; ++i)
+        blk->items[i] = blk->items[i + 1];
+
+    blk->count--;
+    m_size--;
+
+    if (!blk->count)
+        unlink_block(blk);
+    else
+        rebalance(blk);
+}
+
+/*
+ * Merges an underfull block with its successor, or refills it from there.
+ * The last block has no successor and is merged into its predecessor instead
+ * when both fit in one block.
+ */
+template <class T, size_t BlockSize>
+void unrolled_list<T, BlockSize>::rebalance(block_t* blk)
+{
+    if (blk->count >= BlockSize / 2)
+        return;
+
+    block_t* next = blk->next;
+    if (!next)
+    {
+        block_t* prev = blk->prev;
+        if (!prev || prev->count + blk->count > BlockSize)
+            return;
+
+        for (size_t i = 0; i < blk->count; ++i)
+            prev->items[prev->count + i] = blk->items[i];
+
+        prev->count += blk->count;
+        unlink_block(blk);
+        return;
+    }
+
+    if (blk->count + next->count <= BlockSize)
+    {
+        for (size_t i = 0; i < next->count; ++i)
+            blk->items[blk->count + i] = next->items[i];
+
+        blk->count += next->count;
+        unlink_block(next);
+        return;
+    }
+
+    size_t moved = (blk->count + next->count) / 2 - blk->count;
+    for (size_t i = 0; i < moved; ++i)
+        blk->items[blk->count + i] = next->items[i];
+    for (size_t i = moved; i < next->count; ++i)
+        next->items[i - moved] = next->items[i];
+
+    blk->count += moved;
+    next->count -= moved;
+}
+
+} // namespace orla
@@ -2,14 +2,32 @@
 
 #include <cstddef>
 #include <stdexcept>
+#include "bounds.hpp"
+#include "stats.hpp"
 
 namespace orla
 {
 
 static const size_t initial_vector_capacity = 16;
 
+/**
+ * default_allocator - storage policy of vector backed by new[] and delete[]
+ *
+ * An allocator provides static allocate(capacity), deallocate(array,
+ * capacity) and reallocate(array, capacity, new_capacity, size); the latter
+ * returns an array of new_capacity items starting with the first size items
+ * of array, which it releases.
+ */
 template <class T>
-class vector
+struct default_allocator
+{
+    static T*   allocate(const size_t capacity);
+    static void deallocate(T* array, const size_t capacity);
+    static T*   reallocate(T* array, const size_t capacity, const size_t new_capacity, const size_t size);
+};
+
+template <class T, class Allocator = default_allocator<T>, class Stats = null_stats, class Bounds = checked_bounds>
+class vector : private Stats
 {
 public:
     typedef bool (*item_comparator)(const T& a, const T& b);
@@ -23,14 +41,28 @@ public:
     bool   is_empty();
 
     T&   at(const size_t index);
+    T&   operator[](const size_t index) noexcept;
+    T*   data();
+    T*   begin();
+    T*   end();
     void push(const T& item);
     void insert(const size_t index, const T& item);
     void prepend(const T& item);
+    T*   extend(const size_t count);
     T    pop();
+    T    pop_unchecked();
     void erase_at(const size_t index);
     void remove(const T& item);
+    void truncate(const size_t new_size);
+    void clear();
     int  find(const T& item);
 
+    access_error try_at(const size_t index, T** item) noexcept;
+    access_error try_pop(T* item);
+
+    using Stats::stats;
+    using Stats::reset_stats;
+
 private:
     /* data */
     size_t          m_capacity;
@@ -48,7 +80,32 @@ private:
 };
 
 template <class T>
-vector<T>::vector(item_comparator comparator)
+T* default_allocator<T>::allocate(const size_t capacity)
+{
+    return new T[capacity];
+}
+
+template <class T>
+void default_allocator<T>::deallocate(T* array, const size_t)
+{
+    delete[] array;
+}
+
+template <class T>
+T* default_allocator<T>::reallocate(T* array, const size_t, const size_t new_capacity, const size_t size)
+{
+    T* temp_array = new T[new_capacity];
+    for (size_t i = 0; i < size; ++i)
+    {
+        *(temp_array + i) = *(array + i);
+    }
+
+    delete[] array;
+    return temp_array;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+vector<T, Allocator, Stats, Bounds>::vector(item_comparator comparator)
     : m_capacity{ initial_vector_capacity }
     , m_size{ 0 }
     , m_array{ nullptr }
@@ -58,45 +115,70 @@ vector<T>::vector(item_comparator comparator)
     {
         throw std::invalid_argument("Comparator cannot be null");
     }
-    m_array = new T[m_capacity];
+    m_array = Allocator::allocate(m_capacity);
+    this->count_allocation(m_capacity * sizeof(T));
 }
 
-template <class T>
-vector<T>::~vector()
+template <class T, class Allocator, class Stats, class Bounds>
+vector<T, Allocator, Stats, Bounds>::~vector()
 {
     if (m_array)
-        delete[] m_array;
+        Allocator::deallocate(m_array, m_capacity);
 }
 
-template <class T>
-size_t vector<T>::size()
+template <class T, class Allocator, class Stats, class Bounds>
+size_t vector<T, Allocator, Stats, Bounds>::size()
 {
     return m_size;
 }
 
-template <class T>
-size_t vector<T>::capacity()
+template <class T, class Allocator, class Stats, class Bounds>
+size_t vector<T, Allocator, Stats, Bounds>::capacity()
 {
     return m_capacity;
 }
 
-template <class T>
-bool vector<T>::is_empty()
+template <class T, class Allocator, class Stats, class Bounds>
+bool vector<T, Allocator, Stats, Bounds>::is_empty()
 {
     return !m_size;
 }
 
-template <class T>
-T& vector<T>::at(const size_t index)
+template <class T, class Allocator, class Stats, class Bounds>
+T& vector<T, Allocator, Stats, Bounds>::at(const size_t index)
 {
-    if (index >= m_size)
-        throw std::out_of_range("Out of range index");
+    Bounds::check_index(index < m_size, "Out of range index");
 
     return *(m_array + index);
 }
 
-template <class T>
-void vector<T>::push(const T& item)
+/* Never checks index, whatever the Bounds policy */
+template <class T, class Allocator, class Stats, class Bounds>
+T& vector<T, Allocator, Stats, Bounds>::operator[](const size_t index) noexcept
+{
+    return *(m_array + index);
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+T* vector<T, Allocator, Stats, Bounds>::data()
+{
+    return m_array;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+T* vector<T, Allocator, Stats, Bounds>::begin()
+{
+    return m_array;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+T* vector<T, Allocator, Stats, Bounds>::end()
+{
+    return m_array + m_size;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::push(const T& item)
 {
     check_resize();
 
@@ -104,12 +186,10 @@ void vector<T>::push(const T& item)
     m_size++;
 }
 
-template <class T>
-void vector<T>::insert(const size_t index, const T& item)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::insert(const size_t index, const T& item)
 {
-    if (index > m_size)
-        throw std::out_of_range("Out of range index to insert item.\
-                                Index should be <= size()");
+    Bounds::check_index(index <= m_size, "Out of range index to insert item. Index should be <= size()");
 
     if (m_size && !resized_to_insert_at(index))
     {
@@ -119,51 +199,99 @@ void vector<T>::insert(const size_t index, const T& item)
         {
             *(m_array + i + 1) = *(m_array + i);
         }
+        this->count_moves(m_size - index);
     }
 
     *(m_array + index) = item;
     m_size++;
 }
 
-template <class T>
-void vector<T>::prepend(const T& item)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::prepend(const T& item)
 {
     insert(0, item);
 }
 
-template <class T>
-T vector<T>::pop()
+/* Appends count default constructed items and returns a pointer to the first */
+template <class T, class Allocator, class Stats, class Bounds>
+T* vector<T, Allocator, Stats, Bounds>::extend(const size_t count)
 {
-    if (!m_size)
-        throw std::logic_error("Cannot pop from an empty vector");
+    size_t new_capacity = m_capacity;
+    while (new_capacity < m_size + count)
+        new_capacity *= 2;
+
+    if (new_capacity != m_capacity)
+        resize(new_capacity);
+
+    T* first = m_array + m_size;
+    for (size_t i = 0; i < count; ++i)
+        *(first + i) = T();
 
+    m_size += count;
+    return first;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+T vector<T, Allocator, Stats, Bounds>::pop()
+{
+    Bounds::check_not_empty(m_size, "Cannot pop from an empty vector");
+
+    return pop_unchecked();
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+T vector<T, Allocator, Stats, Bounds>::pop_unchecked()
+{
     T ret = *(m_array + m_size - 1);
     post_delete_actions();
     return ret;
 }
 
-template <class T>
-void vector<T>::erase_at(const size_t index)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::erase_at(const size_t index)
 {
-    if (!m_size || index >= m_size)
-        throw std::out_of_range("Out of range index to delete item.");
+    Bounds::check_index(index < m_size, "Out of range index to delete item.");
 
     if (index == m_size - 1)
     {
-        pop();
+        pop_unchecked();
         return;
     }
 
     for (size_t i = index; i < m_size - 1; ++i)
         *(m_array + i) = *(m_array + i + 1);
+    this->count_moves(m_size - 1 - index);
 
     post_delete_actions();
 
     return;
 }
 
-template <class T>
-int vector<T>::find(const T& item)
+/* Drops the items from new_size on, shrinking the array at most once */
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::truncate(const size_t new_size)
+{
+    Bounds::check_index(new_size <= m_size, "Out of range size to truncate to");
+
+    m_size = new_size;
+
+    size_t new_capacity = m_capacity;
+    while (m_size && m_size <= new_capacity / 4)
+        new_capacity /= 2;
+
+    if (new_capacity != m_capacity)
+        resize(new_capacity);
+}
+
+/* Drops every item but keeps the capacity, so refilling does not reallocate */
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::clear()
+{
+    m_size = 0;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+int vector<T, Allocator, Stats, Bounds>::find(const T& item)
 {
     if (!m_size)
         return -1;
@@ -171,14 +299,18 @@ int vector<T>::find(const T& item)
     for (size_t i = 0; i < m_size; ++i)
     {
         if (m_comparator(*(m_array + i), item))
+        {
+            this->count_comparisons(i + 1);
             return i;
+        }
     }
 
+    this->count_comparisons(m_size);
     return -1;
 }
 
-template <class T>
-void vector<T>::remove(const T& item)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::remove(const T& item)
 {
     if (!m_size)
         return;
@@ -190,8 +322,8 @@ void vector<T>::remove(const T& item)
     return;
 }
 
-template <class T>
-int vector<T>::find_from_index(const size_t index, const T& item)
+template <class T, class Allocator, class Stats, class Bounds>
+int vector<T, Allocator, Stats, Bounds>::find_from_index(const size_t index, const T& item)
 {
     if (!m_size || index >= m_size)
         return -1;
@@ -199,32 +331,53 @@ int vector<T>::find_from_index(const size_t index, const T& item)
     for (size_t i = index; i < m_size; ++i)
     {
         if (m_comparator(*(m_array + i), item))
+        {
+            this->count_comparisons(i - index + 1);
             return i;
+        }
     }
 
+    this->count_comparisons(m_size - index);
     return -1;
 }
 
-template <class T>
-void vector<T>::resize(const size_t new_capacity)
+/* Points item at the item at index, or returns out_of_range and leaves it untouched */
+template <class T, class Allocator, class Stats, class Bounds>
+access_error vector<T, Allocator, Stats, Bounds>::try_at(const size_t index, T** item) noexcept
 {
-    if (new_capacity < m_size)
-        throw std::logic_error("Loss of data due to resizing");
+    if (index >= m_size)
+        return access_error::out_of_range;
 
-    T* temp_array = new T[new_capacity];
-    for (size_t i = 0; i < m_size; ++i)
-    {
-        *(temp_array + i) = *(m_array + i);
-    }
+    *item = m_array + index;
+    return access_error::none;
+}
 
-    delete[] m_array;
-    m_array = temp_array;
+template <class T, class Allocator, class Stats, class Bounds>
+access_error vector<T, Allocator, Stats, Bounds>::try_pop(T* item)
+{
+    if (!m_size)
+        return access_error::empty;
+
+    *item = pop_unchecked();
+    return access_error::none;
+}
+
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::resize(const size_t new_capacity)
+{
+    if (new_capacity < m_size)
+        throw std::logic_error("Loss of data due to resizing");
 
+    m_array    = Allocator::reallocate(m_array, m_capacity, new_capacity, m_size);
     m_capacity = new_capacity;
+
+    this->count_resize();
+    this->count_allocation(new_capacity * sizeof(T));
+    this->count_moves(m_size);
 }
 
-template <class T>
-void vector<T>::check_resize(bool will_add)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::check_resize(bool will_add)
 {
     if (will_add && m_size >= m_capacity)
     {
@@ -236,8 +389,8 @@ void vector<T>::check_resize(bool will_add)
     }
 }
 
-template <class T>
-void vector<T>::resize_with_gap(const size_t new_capacity, const size_t gap_index)
+template <class T, class Allocator, class Stats, class Bounds>
+void vector<T, Allocator, Stats, Bounds>::resize_with_gap(const size_t new_capacity, const size_t gap_index)
 {
     if (new_capacity <= m_size)
         throw std::logic_error("Loss of data due to resizing with gap. \
@@ -246,7 +399,7 @@ void vector<T>::resize_with_gap(const size_t new_capacity, const size_t gap_inde
     if (gap_index > m_size)
         throw std::logic_error("Out of range index to add a gap");
 
-    T* temp_array = new T[new_capacity];
+    T* temp_array = Allocator::allocate(new_capacity);
 
     for (size_t i = 0; i < gap_index; ++i)
         *(temp_array + i) = *(m_array + i);
@@ -254,14 +407,18 @@ void vector<T>::resize_with_gap(const size_t new_capacity, const size_t gap_inde
     for (size_t i = gap_index + 1; i <= m_size; ++i)
         *(temp_array + i) = *(m_array + i - 1);
 
-    delete[] m_array;
+    Allocator::deallocate(m_array, m_capacity);
     m_array = temp_array;
 
     m_capacity = new_capacity;
+
+    this->count_resize();
+    this->count_allocation(new_capacity * sizeof(T));
+    this->count_moves(m_size);
 }
 
-template <class T>
-bool vector<T>::resized_to_insert_at(const size_t index)
+template <class T, class Allocator, class Stats, class Bounds>
+bool vector<T, Allocator, Stats, Bounds>::resized_to_insert_at(const size_t index)
 {
     if (m_size >= m_capacity)
     {
@@ -272,8 +429,8 @@ bool vector<T>::resized_to_insert_at(const size_t index)
     return false;
 }
 
-template <class T>
-inline void vector<T>::post_delete_actions()
+template <class T, class Allocator, class Stats, class Bounds>
+inline void vector<T, Allocator, Stats, Bounds>::post_delete_actions()
 {
     m_size--;
     check_resize(false);
@@ -0,0 +1,675 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace orla
+{
+namespace views
+{
+
+/**
+ * Lazy views over orla::vector, singly_linked_list and doubly_linked_list
+ *
+ * A view is a pair of iterators plus the state of its stage; nothing is
+ * copied or allocated until the pipeline is walked. Stages compose with |
+ *
+ *     auto evens = numbers | views::filter(is_even) | views::transform(square) | views::take(10);
+ *     for (int n : evens) ...
+ *
+ * and every element flows through all stages in a single pass. A container
+ * at the head of a pipeline is referenced, not copied, so it must outlive
+ * the view and keep its size while the view is walked. materialize() copies
+ * the elements of a view into a container.
+ */
+struct view_base
+{
+};
+
+struct adaptor_base
+{
+};
+
+template <class It>
+class range : public view_base
+{
+public:
+    range(It first, It last)
+        : m_first{ first }
+        , m_last{ last }
+    {
+    }
+
+    It begin() const
+    {
+        return m_first;
+    }
+    It end() const
+    {
+        return m_last;
+    }
+
+private:
+    It m_first;
+    It m_last;
+};
+
+namespace detail
+{
+
+template <class R>
+using iterator_t = decltype(std::declval<R&>().begin());
+
+template <class It>
+using category_t = typename std::iterator_traits<It>::iterator_category;
+
+template <class It>
+using is_bidirectional = std::is_base_of<std::bidirectional_iterator_tag, category_t<It>>;
+
+/* Views stop at bidirectional, random access is not forwarded */
+template <class It>
+using bidirectional_or_forward_t =
+    typename std::conditional<is_bidirectional<It>::value, std::bidirectional_iterator_tag, std::forward_iterator_tag>::type;
+
+template <class R>
+typename std::decay<R>::type view_of(R&& view, std::true_type)
+{
+    return view;
+}
+
+template <class R>
+range<iterator_t<R>> view_of(R&& container, std::false_type)
+{
+    return range<iterator_t<R>>(container.begin(), container.end());
+}
+
+/* Views are taken by value, containers are wrapped into a range over them */
+template <class R>
+auto view_of(R&& r) -> decltype(view_of(std::forward<R>(r), std::is_base_of<view_base, typename std::decay<R>::type>{}))
+{
+    return view_of(std::forward<R>(r), std::is_base_of<view_base, typename std::decay<R>::type>{});
+}
+
+template <class It>
+It advance_bounded(It it, const It& last, size_t n, std::random_access_iterator_tag)
+{
+    size_t left = last - it;
+    return it + (n < left ? n : left);
+}
+
+template <class It>
+It advance_bounded(It it, const It& last, size_t n, std::forward_iterator_tag)
+{
+    while (n-- && it != last)
+        ++it;
+    return it;
+}
+
+/* Moves at most n steps, stopping at last */
+template <class It>
+It advance_bounded(It it, const It& last, const size_t n)
+{
+    return advance_bounded(it, last, n, category_t<It>{});
+}
+
+template <class V, class C>
+auto append(C& out, V&& value, int) -> decltype(out.push_back(std::forward<V>(value)), void())
+{
+    out.push_back(std::forward<V>(value));
+}
+
+template <class V, class C>
+auto append(C& out, V&& value, long) -> decltype(out.push(std::forward<V>(value)), void())
+{
+    out.push(std::forward<V>(value));
+}
+
+} // namespace detail
+
+template <class R, class A, class = typename std::enable_if<std::is_base_of<adaptor_base, A>::value>::type>
+auto operator|(R&& r, const A& adaptor) -> decltype(adaptor(detail::view_of(std::forward<R>(r))))
+{
+    return adaptor(detail::view_of(std::forward<R>(r)));
+}
+
+template <class R>
+auto all(R&& r) -> decltype(detail::view_of(std::forward<R>(r)))
+{
+    return detail::view_of(std::forward<R>(r));
+}
+
+/* Appends every element of the view with out.push_back() or out.push() */
+template <class R, class C>
+C& materialize(R&& r, C& out)
+{
+    auto view = detail::view_of(std::forward<R>(r));
+    for (auto it = view.begin(); it != view.end(); ++it)
+        detail::append(out, *it, 0);
+
+    return out;
+}
+
+/* filter - elements for which pred returns true */
+template <class V, class Pred>
+class filter_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+public:
+    class iterator
+    {
+    public:
+        typedef detail::bidirectional_or_forward_t<base_iterator>             iterator_category;
+        typedef typename std::iterator_traits<base_iterator>::value_type      value_type;
+        typedef typename std::iterator_traits<base_iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits<base_iterator>::pointer         pointer;
+        typedef typename std::iterator_traits<base_iterator>::reference       reference;
+
+        iterator()
+            : m_it{}
+            , m_last{}
+            , m_pred{ nullptr }
+        {
+        }
+        iterator(base_iterator it, base_iterator last, const Pred* pred)
+            : m_it{ it }
+            , m_last{ last }
+            , m_pred{ pred }
+        {
+            satisfy();
+        }
+
+        reference operator*() const
+        {
+            return *m_it;
+        }
+        iterator& operator++()
+        {
+            ++m_it;
+            satisfy();
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+        /* Steps back to the previous element pred accepts, which must exist */
+        iterator& operator--()
+        {
+            do
+                --m_it;
+            while (!(*m_pred)(*m_it));
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator ret = *this;
+            --*this;
+            return ret;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return m_it == other.m_it;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return m_it != other.m_it;
+        }
+
+    private:
+        base_iterator m_it;
+        base_iterator m_last;
+        const Pred*   m_pred;
+
+        void satisfy()
+        {
+            while (m_it != m_last && !(*m_pred)(*m_it))
+                ++m_it;
+        }
+    };
+
+    filter_view(V base, Pred pred)
+        : m_base{ base }
+        , m_pred{ pred }
+    {
+    }
+
+    iterator begin()
+    {
+        return iterator(m_base.begin(), m_base.end(), &m_pred);
+    }
+    iterator end()
+    {
+        return iterator(m_base.end(), m_base.end(), &m_pred);
+    }
+
+private:
+    V    m_base;
+    Pred m_pred;
+};
+
+/* transform - fn applied to every element as it is read */
+template <class V, class Fn>
+class transform_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+public:
+    class iterator
+    {
+    public:
+        typedef detail::bidirectional_or_forward_t<base_iterator>                   iterator_category;
+        typedef decltype(std::declval<const Fn&>()(*std::declval<base_iterator>())) reference;
+        typedef typename std::decay<reference>::type                                value_type;
+        typedef typename std::iterator_traits<base_iterator>::difference_type       difference_type;
+        typedef void                                                                pointer;
+
+        iterator()
+            : m_it{}
+            , m_fn{ nullptr }
+        {
+        }
+        iterator(base_iterator it, const Fn* fn)
+            : m_it{ it }
+            , m_fn{ fn }
+        {
+        }
+
+        reference operator*() const
+        {
+            return (*m_fn)(*m_it);
+        }
+        iterator& operator++()
+        {
+            ++m_it;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator ret = *this;
+            ++m_it;
+            return ret;
+        }
+        iterator& operator--()
+        {
+            --m_it;
+            return *this;
+        }
+        iterator operator--(int)
+        {
+            iterator ret = *this;
+            --m_it;
+            return ret;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return m_it == other.m_it;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return m_it != other.m_it;
+        }
+
+    private:
+        base_iterator m_it;
+        const Fn*     m_fn;
+    };
+
+    transform_view(V base, Fn fn)
+        : m_base{ base }
+        , m_fn{ fn }
+    {
+    }
+
+    iterator begin()
+    {
+        return iterator(m_base.begin(), &m_fn);
+    }
+    iterator end()
+    {
+        return iterator(m_base.end(), &m_fn);
+    }
+
+private:
+    V  m_base;
+    Fn m_fn;
+};
+
+/* take - at most the first count elements */
+template <class V>
+class take_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+public:
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag                                     iterator_category;
+        typedef typename std::iterator_traits<base_iterator>::value_type      value_type;
+        typedef typename std::iterator_traits<base_iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits<base_iterator>::pointer         pointer;
+        typedef typename std::iterator_traits<base_iterator>::reference       reference;
+
+        iterator()
+            : m_it{}
+            , m_last{}
+            , m_remaining{ 0 }
+        {
+        }
+        iterator(base_iterator it, base_iterator last, size_t remaining)
+            : m_it{ it }
+            , m_last{ last }
+            , m_remaining{ remaining }
+        {
+        }
+
+        reference operator*() const
+        {
+            return *m_it;
+        }
+        iterator& operator++()
+        {
+            ++m_it;
+            m_remaining--;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+        /* The base is never advanced past the count, so end() needs no walk */
+        bool operator==(const iterator& other) const
+        {
+            return is_done() == other.is_done() && (is_done() || m_it == other.m_it);
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        base_iterator m_it;
+        base_iterator m_last;
+        size_t        m_remaining;
+
+        bool is_done() const
+        {
+            return !m_remaining || m_it == m_last;
+        }
+    };
+
+    take_view(V base, const size_t count)
+        : m_base{ base }
+        , m_count{ count }
+    {
+    }
+
+    iterator begin()
+    {
+        return iterator(m_base.begin(), m_base.end(), m_count);
+    }
+    iterator end()
+    {
+        return iterator(m_base.end(), m_base.end(), 0);
+    }
+
+private:
+    V      m_base;
+    size_t m_count;
+};
+
+/* drop - everything after the first count elements */
+template <class V>
+class drop_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+public:
+    drop_view(V base, const size_t count)
+        : m_base{ base }
+        , m_count{ count }
+    {
+    }
+
+    /* Skips count elements on every call, lists are walked each time */
+    base_iterator begin()
+    {
+        return detail::advance_bounded(m_base.begin(), m_base.end(), m_count);
+    }
+    base_iterator end()
+    {
+        return m_base.end();
+    }
+
+private:
+    V      m_base;
+    size_t m_count;
+};
+
+/* chunk - consecutive sub-ranges of size elements, the last one may be shorter */
+template <class V>
+class chunk_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+public:
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag                                     iterator_category;
+        typedef range<base_iterator>                                          value_type;
+        typedef typename std::iterator_traits<base_iterator>::difference_type difference_type;
+        typedef void                                                          pointer;
+        typedef range<base_iterator>                                          reference;
+
+        iterator()
+            : m_first{}
+            , m_next{}
+            , m_last{}
+            , m_size{ 0 }
+        {
+        }
+        iterator(base_iterator first, base_iterator last, const size_t size)
+            : m_first{ first }
+            , m_next{ detail::advance_bounded(first, last, size) }
+            , m_last{ last }
+            , m_size{ size }
+        {
+        }
+
+        reference operator*() const
+        {
+            return range<base_iterator>(m_first, m_next);
+        }
+        iterator& operator++()
+        {
+            m_first = m_next;
+            m_next  = detail::advance_bounded(m_next, m_last, m_size);
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator ret = *this;
+            ++*this;
+            return ret;
+        }
+        bool operator==(const iterator& other) const
+        {
+            return m_first == other.m_first;
+        }
+        bool operator!=(const iterator& other) const
+        {
+            return m_first != other.m_first;
+        }
+
+    private:
+        base_iterator m_first;
+        base_iterator m_next;
+        base_iterator m_last;
+        size_t        m_size;
+    };
+
+    chunk_view(V base, const size_t size)
+        : m_base{ base }
+        , m_size{ size }
+    {
+    }
+
+    iterator begin()
+    {
+        return iterator(m_base.begin(), m_base.end(), m_size);
+    }
+    iterator end()
+    {
+        return iterator(m_base.end(), m_base.end(), m_size);
+    }
+
+private:
+    V      m_base;
+    size_t m_size;
+};
+
+/* reversed - the elements back to front, end() is decremented in place */
+template <class V>
+class reversed_view : public view_base
+{
+    typedef detail::iterator_t<V> base_iterator;
+
+    static_assert(detail::is_bidirectional<base_iterator>::value,
+                  "reversed needs bidirectional iterators, singly_linked_list cannot be reversed lazily");
+
+public:
+    typedef std::reverse_iterator<base_iterator> iterator;
+
+    explicit reversed_view(V base)
+        : m_base{ base }
+    {
+    }
+
+    /* Built from the owned base, whose iterators may point into its stage state */
+    iterator begin()
+    {
+        return iterator(m_base.end());
+    }
+    iterator end()
+    {
+        return iterator(m_base.begin());
+    }
+
+private:
+    V m_base;
+};
+
+template <class Pred>
+class filter_adaptor : public adaptor_base
+{
+public:
+    explicit filter_adaptor(Pred pred)
+        : m_pred{ pred }
+    {
+    }
+
+    template <class V>
+    filter_view<V, Pred> operator()(V view) const
+    {
+        return filter_view<V, Pred>(view, m_pred);
+    }
+
+private:
+    Pred m_pred;
+};
+
+template <class Fn>
+class transform_adaptor : public adaptor_base
+{
+public:
+    explicit transform_adaptor(Fn fn)
+        : m_fn{ fn }
+    {
+    }
+
+    template <class V>
+    transform_view<V, Fn> operator()(V view) const
+    {
+        return transform_view<V, Fn>(view, m_fn);
+    }
+
+private:
+    Fn m_fn;
+};
+
+template <template <class> class View>
+class count_adaptor : public adaptor_base
+{
+public:
+    explicit count_adaptor(const size_t count)
+        : m_count{ count }
+    {
+    }
+
+    template <class V>
+    View<V> operator()(V view) const
+    {
+        return View<V>(view, m_count);
+    }
+
+private:
+    size_t m_count;
+};
+
+class reversed_adaptor : public adaptor_base
+{
+public:
+    /* O(1) when the iterators are bidirectional */
+    template <class V>
+    reversed_view<V> operator()(V view) const
+    {
+        return reversed_view<V>(view);
+    }
+};
+
+template <class Pred>
+filter_adaptor<Pred> filter(Pred pred)
+{
+    return filter_adaptor<Pred>(pred);
+}
+
+template <class Fn>
+transform_adaptor<Fn> transform(Fn fn)
+{
+    return transform_adaptor<Fn>(fn);
+}
+
+inline count_adaptor<take_view> take(const size_t count)
+{
+    return count_adaptor<take_view>(count);
+}
+
+inline count_adaptor<drop_view> drop(const size_t count)
+{
+    return count_adaptor<drop_view>(count);
+}
+
+inline count_adaptor<chunk_view> chunk(const size_t size)
+{
+    if (!size)
+        throw std::invalid_argument("Chunk size cannot be zero");
+
+    return count_adaptor<chunk_view>(size);
+}
+
+inline reversed_adaptor reversed()
+{
+    return reversed_adaptor();
+}
+
+} // namespace views
+} // namespace orla